@@ -11,17 +11,82 @@
  *
  * Для режима "Бот против Бота" добавлена перегрузка функции getBestMove,
  * позволяющая задать дополнительный параметр maximizingPlayer.
+ *
+ * Размер доски – параметр шаблона BasicAlphaBetaAI<N>; AlphaBetaAI – поисковик для доски 15x15.
  */
 
 #include "game-logic.h"
+#include "opening-book.h"
+#include "search-stats.h"
+#include "threat-solver.h"
+#include "transposition-table.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
 #include <utility>
 #include <vector>
 #include <limits>
 
-class AlphaBetaAI {
+/**
+ * @brief Алгоритм перебора.
+ */
+enum class SearchMode {
+    AlphaBeta, // Альфа-бета с полным окном в каждом узле и в корне.
+    Pvs        // Principal Variation Search: нулевые окна для всех ходов, кроме первого,
+               // и окна стремления в корне вокруг оценки итерации той же чётности.
+};
+
+/**
+ * @brief Ограничения поиска.
+ */
+struct SearchLimits {
+    int maxDepth = 4;     // Максимальная глубина итеративного углубления.
+    int timeLimitMs = 0;  // Лимит времени на ход в миллисекундах (0 – без ограничения).
+    long long threatNodeLimit = 20000; // Лимит узлов для каждого из поисков VCF и VCT (0 – не искать).
+    SearchMode mode = SearchMode::Pvs;  // Алгоритм перебора.
+    bool useBook = true;  // Брать ход из дебютной книги, если она задана и содержит позицию.
+    bool lateMoveReductions = true; // Сокращать глубину поздних тихих ходов (LMR).
+    bool futilityPruning = true;    // Не перебирать тихие ходы у листьев, если оценка безнадёжно ниже alpha.
+    bool nullMovePruning = true;    // Отсекать узлы по поиску после пропуска хода.
+    int quiescenceNodeLimit = 64;   // Лимит узлов продления угроз от одного листа (0 – без продления).
+};
+
+/**
+ * @brief Результат поиска.
+ */
+struct SearchResult {
+    std::pair<int, int> move = std::make_pair(-1, -1); // Лучший ход или (-1, -1), если ходов нет.
+    int score = 0;         // Оценка лучшего хода (с точки зрения AI).
+    int depth = 0;         // Глубина последней завершённой итерации.
+    long long nodes = 0;   // Число посещённых узлов (во всех потоках).
+    long long timeMs = 0;  // Затраченное время в миллисекундах.
+    int forcedLength = 0;  // Длина форсированного выигрыша от ThreatSolver (0 – не найден); серия – в stats.pv.
+    SearchStats stats;     // Подробная статистика поиска (см. search-stats.h).
+    bool fromBook = false; // Ход взят из дебютной книги без поиска.
+
+    // Доля отсечений, случившихся на первом ходе (0..1) – мера качества упорядочивания ходов
+    // (считается только с GOMOKU_SEARCH_STATS, см. SearchStats::firstMoveCutoffRate).
+    double firstMoveCutoffRate() const { return stats.firstMoveCutoffRate(); }
+};
+
+template <int N>
+class BasicAlphaBetaAI {
 public:
+    using Game = BasicGameLogic<N>; // Позиция, в которой ищется ход.
+
+    static constexpr int MAX_SEARCH_DEPTH = 64; // Предельная глубина поиска с ограничением по времени.
+
     // Конструктор – дополнительная инициализация не требуется.
-    AlphaBetaAI();
+    BasicAlphaBetaAI();
+
+    // Деструктор вспомогательного поисковика останавливает и дожидается его поток.
+    ~BasicAlphaBetaAI();
 
     /**
      * @brief getBestMove Определяет лучший ход для ИИ (по умолчанию для максимизирующего игрока).
@@ -29,7 +94,7 @@ public:
      * @param depth Глубина поиска.
      * @return Пара координат (row, col) для лучшего хода.
      */
-    std::pair<int, int> getBestMove(GameLogic &game, int depth);
+    std::pair<int, int> getBestMove(Game &game, int depth);
 
     /**
      * @brief getBestMove Перегруженный метод, определяющий лучший ход для выбранного игрока.
@@ -39,28 +104,289 @@ public:
      *                         если false – для минимизирующего.
      * @return Пара координат (row, col) для лучшего хода.
      */
-    std::pair<int, int> getBestMove(GameLogic &game, int depth, bool maximizingPlayer);
+    std::pair<int, int> getBestMove(Game &game, int depth, bool maximizingPlayer);
+
+    /**
+     * @brief getBestMoveTimed Определяет лучший ход за отведённое время.
+     * @param game Текущее состояние игры.
+     * @param budgetMs Лимит времени на ход в миллисекундах.
+     * @param maximizingPlayer Для какого игрока ищется ход (true – AI).
+     * @return Ход последней итерации, завершённой до истечения лимита.
+     */
+    std::pair<int, int> getBestMoveTimed(Game &game, int budgetMs, bool maximizingPlayer = true);
+
+    /**
+     * @brief search Поиск с итеративным углублением в заданных ограничениях.
+     *
+     * Перебираются только ходы-кандидаты из фронтира позиции (см. GameLogic::setCandidateRadius);
+     * ходы, запрещённые правилами позиции (чёрным в рэндзю), отбрасываются.
+     *
+     * @param game Текущее состояние игры.
+     * @param limits Ограничения по глубине и времени.
+     * @param maximizingPlayer Для какого игрока ищется ход (true – AI).
+     * @return Лучший ход вместе с оценкой, достигнутой глубиной и статистикой.
+     */
+    SearchResult search(Game &game, const SearchLimits &limits, bool maximizingPlayer = true);
+
+    /**
+     * @brief requestStop Просит прервать текущий поиск (потокобезопасно).
+     *
+     * Запрос действует, пока не будет вызван clearStopRequest(), поэтому
+     * его нельзя "потерять", даже если поиск ещё не успел начаться.
+     */
+    void requestStop();
+
+    // Сбрасывает запрос на остановку перед запуском нового поиска.
+    void clearStopRequest();
+
+    /**
+     * @brief setProgressCallback Задаёт функцию, вызываемую после каждой завершённой итерации.
+     *
+     * Функция вызывается в потоке поиска и получает промежуточный результат
+     * (лучший ход, достигнутая глубина, число узлов, время).
+     */
+    void setProgressCallback(std::function<void(const SearchResult &)> callback);
+
+    /**
+     * @brief setThreadCount Задаёт число потоков поиска (1 – последовательный поиск).
+     *
+     * При threads > 1 поиск идёт по схеме Lazy SMP: вспомогательные потоки ищут ту же позицию
+     * на своих копиях доски с другим порядком ходов в корне и делятся результатами
+     * через общую таблицу транспозиций, а ход выбирает основной поток.
+     *
+     * @param threads Число потоков, включая основной.
+     */
+    void setThreadCount(int threads);
+    int getThreadCount() const { return threadCount; }
+
+    /**
+     * @brief setHashSize Задаёт размер таблицы транспозиций.
+     * @param sizeMb Размер в мегабайтах.
+     */
+    void setHashSize(std::size_t sizeMb);
+
+    // Очищает таблицу транспозиций (например, при начале новой игры).
+    void clearHash();
+
+    /**
+     * @brief setOpeningBook Задаёт дебютную книгу (nullptr – без книги).
+     *
+     * Книга только читается, поэтому одну открытую книгу могут использовать несколько поисковиков.
+     * Книга строится по правилам свободного стиля и при других правилах не используется.
+     */
+    void setOpeningBook(std::shared_ptr<const OpeningBook> book);
+
+    /**
+     * @brief referenceEvaluate Эталонная оценка позиции полным обходом доски.
+     *
+     * Если кто-либо выигрывает, возвращается WIN_SCORE или -WIN_SCORE.
+     * Иначе производится анализ цепочек фишек в 4 направлениях с учётом длины и количества открытых концов.
+     * Используется как эталон для сверки с инкрементальной оценкой в tests/engine-tests.cpp
+     * (совпадает с PatternEvaluator::evaluateBoard(game, false) для позиций без победителя).
+     *
+     * @param game Текущее состояние игры.
+     * @return Оценка позиции.
+     */
+    static int referenceEvaluate(const Game &game);
 
 private:
+    // Вспомогательный поисковик Lazy SMP, использующий общую таблицу транспозиций.
+    explicit BasicAlphaBetaAI(std::shared_ptr<TranspositionTable> sharedTable);
+
+    // Клетка хода (row * BOARD_SIZE + col) в списке ходов: байт, если клеток доски не больше 256.
+    using MoveCell = typename std::conditional<(Game::CELL_COUNT <= 256), uint8_t, uint16_t>::type;
+
+    /**
+     * @brief Список ходов узла фиксированной ёмкости (все клетки доски).
+     *
+     * По списку на уровень дерева хранится в самом поисковике (moveLists, нулевой – ходы корня),
+     * поэтому поиск не выделяет память в куче.
+     */
+    struct MoveList {
+        int count = 0;                    // Число ходов.
+        MoveCell cells[Game::CELL_COUNT]; // Ходы в порядке перебора.
+    };
+
+    /**
+     * @brief helperSearch Итеративное углубление вспомогательного потока Lazy SMP.
+     *
+     * Ищет до maxDepth или до запроса на остановку. Нечётные потоки начинают с глубины 2,
+     * а порядок ходов корня сдвигается на номер потока, чтобы потоки не дублировали работу.
+     * Ходы корня берутся из moveLists[0], куда их перед запуском копирует основной поток.
+     *
+     * @param game Собственная копия позиции потока.
+     * @param maxDepth Максимальная глубина.
+     * @param maximizingPlayer Для какого игрока ищется ход.
+     * @param threadIndex Номер вспомогательного потока (с 1).
+     */
+    void helperSearch(Game &game, int maxDepth, bool maximizingPlayer, int threadIndex);
+
+    // Цикл потока вспомогательного поисковика: ждёт задание (workerBusy), выполняет helperSearch.
+    void workerLoop();
+
     /**
-     * @brief alphaBeta Рекурсивная функция поиска с альфа-бета отсечением.
+     * @brief negamax Рекурсивная функция поиска с альфа-бета отсечением (negamax).
+     * @tparam Side Игрок, который ходит в позиции; оценка считается с его точки зрения.
      * @param game Текущее состояние игры.
      * @param depth Текущая глубина поиска.
-     * @param alpha Текущее значение альфа.
-     * @param beta Текущее значение бета.
-     * @param maximizingPlayer Если true – максимизируем (ход ИИ), иначе – минимизируем (ход игрока).
-     * @return Числовая оценка позиции.
+     * @param ply Расстояние от корня (номер уровня дерева для ходов-убийц).
+     * @param alpha Нижняя граница окна.
+     * @param beta Верхняя граница окна.
+     * @return Оценка позиции для Side.
+     */
+    template <GameLogicBase::Player Side>
+    int negamax(Game &game, int depth, int ply, int alpha, int beta);
+
+    /**
+     * @brief quiescence Продление угроз на горизонте: одна форсированная линия защит от пятёрки
+     * противника, без окна alpha-beta.
+     * @tparam Side Игрок, который ходит в позиции.
+     * @param ply Расстояние от корня.
+     * @param standPat Статическая оценка позиции для Side (без победителя).
+     * @return Оценка позиции для Side.
+     */
+    template <GameLogicBase::Player Side>
+    int quiescence(Game &game, int ply, int standPat);
+
+    /**
+     * @brief searchMove Делает ход игрока Side, ищет позицию с окном по режиму поиска (PVS) и отменяет ход.
+     * @param firstMove Ход первый в своём узле (ищется с полным окном).
+     * @param reduction На сколько сократить глубину (LMR); при оценке выше alpha ход ищется заново без сокращения.
+     * @return Оценка хода для Side.
+     */
+    template <GameLogicBase::Player Side>
+    int searchMove(Game &game, std::pair<int, int> move, int depth, int ply, int alpha, int beta,
+                   bool firstMove, int reduction = 0);
+
+    /**
+     * @brief orderMoves Упорядочивает ходы узла перед перебором.
+     * @param game Текущее состояние игры.
+     * @param moves Ходы узла (сортируются на месте).
+     * @param ttMove Ход из таблицы транспозиций (row * BOARD_SIZE + col) или -1.
+     * @param depth Оставшаяся глубина узла.
+     * @param ply Расстояние от корня.
+     * @param side Чей ход в узле.
+     * @return Номер первого тихого хода: дальше идут ходы, которые не ход из таблицы, не угроза
+     *         и не ход-убийца (угрозы на глубине 1 не распознаются, см. orderMoves).
      */
-    int alphaBeta(GameLogic &game, int depth, int alpha, int beta, bool maximizingPlayer);
+    int orderMoves(const Game &game, MoveList &moves, int ttMove, int depth, int ply, GameLogicBase::Player side);
+
+    /**
+     * @brief recordCutoff Запоминает ход, вызвавший бета-отсечение.
+     *
+     * Тихий ход (не угроза) становится ходом-убийцей уровня ply, а его счётчик
+     * истории увеличивается на depth * depth.
+     */
+    void recordCutoff(const Game &game, std::pair<int, int> move, int depth, int ply,
+                      GameLogicBase::Player side, int moveIndex);
+
+    // Сбрасывает ходы-убийцы и вдвое уменьшает счётчики истории перед новым поиском.
+    void resetOrdering();
+
+    /**
+     * @brief extractPv Восстанавливает главный вариант по ходам из таблицы транспозиций.
+     * @param game Позиция в корне (изменяется во время обхода и восстанавливается).
+     * @param firstMove Лучший ход из корня.
+     * @param maximizingPlayer Чей ход в корне.
+     * @param pv Куда записать вариант.
+     * @param maxLength Наибольшая длина варианта.
+     * @return Длина варианта.
+     */
+    int extractPv(Game &game, std::pair<int, int> firstMove, bool maximizingPlayer, std::pair<int, int> *pv,
+                  int maxLength) const;
+
+    /**
+     * @brief searchRoot Одна итерация поиска в корне.
+     * @param game Текущее состояние игры.
+     * @param depth Глубина итерации.
+     * @param alpha Нижняя граница окна.
+     * @param beta Верхняя граница окна.
+     * @param maximizingPlayer Для какого игрока ищется ход.
+     * @param moves Ходы корня в порядке перебора.
+     * @param bestMove Лучший найденный ход.
+     * @return Оценка лучшего хода с точки зрения ищущего игрока.
+     */
+    int searchRoot(Game &game, int depth, int alpha, int beta, bool maximizingPlayer,
+                   const MoveList &moves, std::pair<int, int> &bestMove);
+
+    // Итерация корня для игрока Side (вызывается из searchRoot).
+    template <GameLogicBase::Player Side>
+    int searchRoot(Game &game, int depth, int alpha, int beta,
+                   const MoveList &moves, std::pair<int, int> &bestMove);
+
+    /**
+     * @brief searchRootAspiration Итерация корня с окном стремления вокруг previousScore.
+     * @return Оценка лучшего хода (окно при необходимости расширяется до полного).
+     */
+    int searchRootAspiration(Game &game, int depth, bool maximizingPlayer, int previousScore,
+                             const MoveList &moves, std::pair<int, int> &bestMove);
+
+    // Учитывает очередной узел; возвращает true, если поиск нужно прервать.
+    bool checkStop();
+
+    // Время с начала текущего поиска в миллисекундах.
+    long long elapsedMs() const;
 
     /**
      * @brief evaluate Оценивает позицию на доске.
      *
      * Если кто-либо выигрывает, возвращается WIN_SCORE или -WIN_SCORE.
-     * Иначе производится анализ цепочек фишек в 4 направлениях с учётом длины и количества открытых концов.
+     * Иначе возвращается инкрементально поддерживаемая оценка GameLogic::evaluation()
+     * (шаблоны на линиях, см. PatternEvaluator) – за O(1).
      *
      * @param game Текущее состояние игры.
      * @return Оценка позиции.
      */
-    int evaluate(GameLogic &game);
+    int evaluate(Game &game);
+
+    // Таблица транспозиций, общая для всех вызовов и потоков поиска. Ключ – канонический хэш позиции
+    // (Game::canonicalHash), поэтому симметричные позиции делят одну запись.
+    std::shared_ptr<TranspositionTable> tt;
+    int threadCount = 1;                      // Число потоков поиска.
+    std::vector<std::unique_ptr<BasicAlphaBetaAI>> helpers; // Вспомогательные поисковики Lazy SMP.
+
+    // Поток вспомогательного поисковика запускается один раз при setThreadCount и между поисками
+    // ждёт задания, поэтому поиск не создаёт потоков и не копирует позицию в новую память.
+    std::thread worker;                   // Поток (только у вспомогательных поисковиков).
+    std::mutex workerMutex;               // Защищает задание и флаги потока.
+    std::condition_variable workerSignal; // Выдача задания, его завершение и выход.
+    bool workerBusy = false;              // Задание выдано и ещё не выполнено.
+    bool workerExit = false;              // Поток должен завершиться.
+    Game workerGame;                      // Позиция корня задания (копия позиции основного потока).
+    int workerMaxDepth = 0;               // Максимальная глубина задания.
+    bool workerMaximizing = true;         // Для какого игрока ищется ход в задании.
+    int workerIndex = 0;                  // Номер вспомогательного потока (с 1).
+
+    std::chrono::steady_clock::time_point startTime; // Время начала поиска.
+    int timeLimitMs = 0;     // Лимит времени текущего поиска (0 – без ограничения).
+    SearchMode searchMode = SearchMode::Pvs; // Алгоритм перебора текущего поиска.
+    bool lateMoveReductions = true; // Приёмы выборочного поиска текущего поиска (см. SearchLimits).
+    bool futilityPruning = true;
+    bool nullMovePruning = true;
+    bool inNullMove = false;     // Поиск идёт под нулевым ходом: второй нулевой ход на пути не делается.
+    int quiescenceNodeLimit = 0; // Лимит узлов продления угроз от одного листа текущего поиска.
+    int quiescenceBudget = 0;    // Сколько узлов осталось продлению текущего листа.
+    long long nodes = 0;     // Число посещённых узлов.
+    std::atomic<long long> publishedNodes{0}; // Копия nodes для чтения из других потоков (обновляется раз в 1024 узла).
+    int completedDepth = 0;  // Глубина последней завершённой итерации.
+    bool stopped = false;    // Поиск прерван (по времени или по запросу).
+    std::atomic<bool> stopRequested{false}; // Внешний запрос на остановку.
+    std::function<void(const SearchResult &)> progressCallback; // Уведомление о завершённой итерации.
+    ThreatSolver threatSolver; // Поиск форсированного выигрыша перед полным перебором.
+    std::shared_ptr<const OpeningBook> openingBook; // Дебютная книга (может отсутствовать).
+
+    int killers[MAX_SEARCH_DEPTH][2];          // Ходы-убийцы по уровням дерева (-1 – нет).
+    bool quietMoves[MAX_SEARCH_DEPTH] = {};    // Ход, сделанный на уровне дерева, тихий (для нулевого хода).
+    int plyMoves[MAX_SEARCH_DEPTH] = {};       // Клетка хода, сделанного на уровне дерева (-1 – нулевой ход).
+    MoveList moveLists[MAX_SEARCH_DEPTH];      // Ходы узлов текущего пути по уровням дерева (0 – корень).
+    long long orderKeys[Game::CELL_COUNT];     // Ключи сортировки orderMoves.
+    int history[2][Game::CELL_COUNT] = {}; // Счётчики истории: [0 – AI, 1 – Human][клетка].
+    SearchStats stats;              // Статистика текущего поиска.
 };
+
+extern template class BasicAlphaBetaAI<15>;
+extern template class BasicAlphaBetaAI<19>;
+extern template class BasicAlphaBetaAI<20>;
+
+// Поисковик для классической доски 15x15.
+using AlphaBetaAI = BasicAlphaBetaAI<15>;
@@ -0,0 +1,101 @@
+#pragma once
+/*
+ * engine-session.h
+ *
+ * Заголовочный файл класса EngineSession – выбора размера доски во время работы.
+ *
+ * Размер доски – параметр шаблонов BasicGameLogic<N> и BasicAlphaBetaAI<N>, поэтому
+ * программе, которая узнаёт размер только во время работы (команда START протокола
+ * Piskvork, выбор в меню), нужен общий интерфейс над всеми собранными размерами.
+ * EngineSession::create(n) выбирает инстанцирование для доски n x n и возвращает сеанс:
+ * позицию с журналом партии и поисковик со своей таблицей транспозиций.
+ *
+ * Виртуальные вызовы делаются только на уровне ходов партии; внутри поиска
+ * работает код, специализированный под размер доски.
+ */
+
+#include "game-logic.h"
+#include "alpha-beta-ai.h"
+#include "opening-book.h"
+#include "swap2-opening.h"
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+class EngineSession {
+public:
+    virtual ~EngineSession() = default;
+
+    /**
+     * @brief create Создаёт сеанс для доски boardSize x boardSize.
+     * @return nullptr, если движок не собран для такого размера (см. supportedBoardSizes).
+     */
+    static std::unique_ptr<EngineSession> create(int boardSize);
+
+    // Размеры доски, для которых собран движок (по возрастанию).
+    static const std::vector<int> &supportedBoardSizes();
+
+    // Размер доски сеанса.
+    virtual int boardSize() const = 0;
+
+    // Очищает доску и журнал партии.
+    virtual void reset() = 0;
+
+    // Содержимое клетки: GameLogicBase::None, Human или AI.
+    virtual int cell(int row, int col) const = 0;
+
+    virtual bool isMoveValid(int row, int col) const = 0;
+
+    // Ход без записи в журнал и его отмена (см. GameLogic::makeMove, GameLogic::undoMove).
+    virtual bool makeMove(int row, int col, GameLogicBase::Player player) = 0;
+    virtual void undoMove(int row, int col) = 0;
+
+    // Ходы партии с журналом (см. GameLogic::playMove, takeBack, redoMove).
+    virtual bool playMove(int row, int col, GameLogicBase::Player player) = 0;
+    virtual bool takeBack() = 0;
+    virtual bool redoMove() = 0;
+    virtual bool canRedo() const = 0;
+    virtual const GameLogicBase::RecordedMove &nextRedoMove() const = 0;
+    virtual const std::vector<GameLogicBase::RecordedMove> &moveLog() const = 0;
+    int moveCount() const { return int(moveLog().size()); }
+
+    virtual int checkWinner() const = 0;
+    virtual bool isBoardFull() const = 0;
+
+    // Правила и игрок чёрными (см. GameLogic::setRules); при смене правил таблица транспозиций очищается.
+    virtual void setRules(GameLogicBase::Rules rules, GameLogicBase::Player black) = 0;
+    virtual GameLogicBase::Rules rules() const = 0;
+    virtual GameLogicBase::Player blackPlayer() const = 0;
+
+    // Запрещён ли ход игрока правилами (см. GameLogic::isForbidden).
+    virtual bool isForbidden(int row, int col, GameLogicBase::Player player) const = 0;
+
+    // Поиск хода в текущей позиции сеанса (см. AlphaBetaAI::search).
+    virtual SearchResult search(const SearchLimits &limits, bool maximizingPlayer) = 0;
+
+    /**
+     * @brief searchFrom Поиск хода в позиции, заданной ходами партии.
+     *
+     * Позиция сеанса заменяется позицией после moves. Удобно для поиска в отдельном потоке:
+     * туда передаётся только копия журнала, а не позиция, которую продолжает менять интерфейс.
+     */
+    virtual SearchResult searchFrom(const std::vector<GameLogicBase::RecordedMove> &moves,
+                                    const SearchLimits &limits, bool maximizingPlayer) = 0;
+
+    /**
+     * @brief swap2 Решение движка в дебюте swap2 (см. Swap2Opening::decide).
+     *
+     * Позиция сеанса заменяется позицией после решения; камни движка – AI.
+     */
+    virtual Swap2Decision swap2(const std::vector<std::pair<int, int>> &stones, const SearchLimits &limits) = 0;
+
+    // Управление поисковиком (см. AlphaBetaAI).
+    virtual void requestStop() = 0;
+    virtual void clearStopRequest() = 0;
+    virtual void setProgressCallback(std::function<void(const SearchResult &)> callback) = 0;
+    virtual void setThreadCount(int threads) = 0;
+    virtual void setHashSize(std::size_t sizeMb) = 0;
+    virtual void clearHash() = 0;
+    virtual void setOpeningBook(std::shared_ptr<const OpeningBook> book) = 0;
+};
@@ -2,15 +2,62 @@
 
 #include <vector>
 #include <utility>
+#include <cstdint>
 
 /*
   Класс GameLogic отвечает за игровую логику.
   Он содержит игровое поле (массив board), методы для проверки и выполнения ходов,
   удаления хода (undo), проверки выигрыша и возвращения списка доступных ходов.
+
+  Помимо массива board, для каждого игрока хранится битовое представление доски:
+  по одной битовой маске на каждую линию в каждом из 4 направлений (строки, столбцы
+  и две диагонали). Маски обновляются в makeMove/undoMove, поэтому проверка
+  пяти в ряд сводится к нескольким сдвигам и операциям AND.
+
+  Также инкрементально поддерживается Zobrist-хеш позиции: каждой паре
+  (игрок, клетка) сопоставлено случайное 64-битное число, и хеш равен XOR
+  чисел всех занятых клеток.
+
+  Доска имеет 8 симметрий (тождественная, повороты на 90/180/270 градусов и четыре
+  отражения). Вместе с хешем поддерживаются хеши всех 8 образов позиции – как есть
+  и с переставленными цветами камней, – поэтому канонический ключ позиции (наименьший
+  из хешей образов) и симметрия, переводящая позицию в каноническую, получаются за O(1).
+  Повёрнутые и отражённые позиции получают один канонический ключ, что используют
+  таблица транспозиций, дебютная книга и кэш ThreatSolver.
+
+  Для поиска поддерживается "фронтир" – множество пустых клеток на расстоянии
+  не больше candidateRadius от какого-либо камня. Оно обновляется при каждом ходе
+  и позволяет ИИ перебирать только ходы рядом с уже стоящими камнями.
+
+  Ходы партии записываются в журнал: playMove добавляет ход (row, col, игрок) – 3 байта
+  на ход, – а takeBack и redoMove отменяют и возвращают ходы за O(1) через стек
+  отменённых ходов. Позиция на любом ходе партии восстанавливается по журналу по запросу
+  (positionAt). Поиск ИИ пользуется makeMove/undoMove, которые журнал не затрагивают.
+
+  Оценка позиции (см. PatternEvaluator) хранится в кэше по линиям: при ходе
+  пересчитываются только 4 линии через изменённую клетку, а итоговая оценка
+  доступна за O(1) через evaluation().
+
+  Размер доски – параметр шаблона BasicGameLogic<N>: все циклы по полю и размеры
+  массивов известны при компиляции, а линия длиной до N клеток умещается в 32-битную
+  маску. Движок собирается для досок 15x15 (GameLogic), 19x19 и 20x20 (Gomocup
+  freestyle); выбор размера во время работы – см. engine-session.h.
+  Игроки, направления и запись журнала не зависят от размера и объявлены в GameLogicBase.
+
+  Правила (setRules) определяют, что считается победой и какие ходы запрещены:
+  свободный стиль (пять и больше в ряд), стандартное гомоку (ровно пять) и рэндзю
+  (ровно пять у чёрных, запрещённые ходы чёрных 3-3, 4-4 и длинный ряд). Для рэндзю
+  поддерживается кэш форм линий через пустые клетки, поэтому проверка запрещённого
+  хода стоит O(1) и годится для генератора ходов поиска (см. renju-rules.h).
 */
-class GameLogic {
+/**
+ * @brief Общая для всех размеров доски часть GameLogic: игроки, направления, запись журнала.
+ */
+class GameLogicBase {
 public:
-    static const int BOARD_SIZE = 15; // Размер игрового поля (15x15)
+    static const int DEFAULT_CANDIDATE_RADIUS = 2;     // Радиус фронтира по умолчанию
+    static const int MAX_CANDIDATE_RADIUS = 4;         // Максимально допустимый радиус фронтира
+    static const int SYMMETRY_COUNT = 8;               // Число симметрий доски
 
     // Определение игроков и пустой клетки
     enum Player {
@@ -19,8 +66,56 @@ public:
         AI = 2      // Компьютер (бот)
     };
 
+    // Направления линий на доске.
+    enum Direction {
+        Horizontal = 0,   // Строка
+        Vertical = 1,     // Столбец
+        Diagonal = 2,     // Диагональ вниз-вправо
+        AntiDiagonal = 3  // Диагональ вверх-вправо
+    };
+
+    // Правила игры.
+    enum Rules {
+        Freestyle = 0, // Побеждает пять и больше в ряд
+        Standard = 1,  // Побеждает ровно пять в ряд, длинный ряд (шесть и больше) не выигрывает
+        Renju = 2      // Рэндзю: у чёрных ровно пять, 3-3, 4-4 и длинный ряд запрещены; у белых пять и больше
+    };
+
+    // Ход в журнале партии.
+    struct RecordedMove {
+        uint8_t row;    // Строка.
+        uint8_t col;    // Столбец.
+        uint8_t player; // Игрок (Human или AI).
+    };
+
+    // Симметрия, обратная symmetry.
+    static int inverseSymmetry(int symmetry) { return (symmetry == 1 || symmetry == 3) ? 4 - symmetry : symmetry; }
+
+    // Возвращает маску начальных позиций всех отрезков из пяти установленных битов.
+    static uint32_t fiveStarts(uint32_t bits) {
+        return bits & (bits >> 1) & (bits >> 2) & (bits >> 3) & (bits >> 4);
+    }
+
+    // Начальные позиции отрезков ровно из пяти битов: соседние с отрезком биты не установлены.
+    static uint32_t exactFiveStarts(uint32_t bits) {
+        return fiveStarts(bits) & ~(bits << 1) & ~(bits >> 5);
+    }
+};
+
+template <int N>
+class BasicGameLogic : public GameLogicBase {
+    static_assert(N >= 5 && N <= 32, "линия доски должна умещаться в 32-битную маску");
+
+public:
+    static constexpr int BOARD_SIZE = N; // Размер игрового поля (NxN)
+    static constexpr int LINE_COUNT = 2 * BOARD_SIZE - 1; // Максимальное число линий в одном направлении (диагонали)
+    static constexpr int CELL_COUNT = BOARD_SIZE * BOARD_SIZE; // Число клеток поля
+
     // Конструктор: инициализирует игровое поле значением None.
-    GameLogic();
+    BasicGameLogic();
+
+    // Очищает игровое поле, все битовые маски и журнал партии.
+    void reset();
 
     // Проверка, является ли ход по координатам (row, col) допустимым.
     bool isMoveValid(int row, int col) const;
@@ -31,15 +126,217 @@ public:
     // Отмена хода на указанной клетке.
     void undoMove(int row, int col);
 
+    /**
+     * @brief playMove Делает ход партии и записывает его в журнал.
+     *
+     * Стек отменённых ходов при этом очищается: после нового хода вернуть их нельзя.
+     * @return false, если ход недопустим.
+     */
+    bool playMove(int row, int col, Player player);
+
+    /**
+     * @brief takeBack Отменяет последний ход из журнала и кладёт его в стек отменённых ходов.
+     * @return false, если журнал пуст.
+     */
+    bool takeBack();
+
+    /**
+     * @brief redoMove Возвращает последний отменённый ход.
+     * @return false, если отменённых ходов нет.
+     */
+    bool redoMove();
+
+    // Журнал партии: сделанные ходы по порядку.
+    const std::vector<RecordedMove> &moveLog() const { return log; }
+
+    // Число ходов в журнале.
+    int moveCount() const { return int(log.size()); }
+
+    // true, если есть отменённые ходы, которые можно вернуть.
+    bool canRedo() const { return !redoLog.empty(); }
+
+    // Ход, который вернёт redoMove() (только при canRedo()).
+    const RecordedMove &nextRedoMove() const { return redoLog.back(); }
+
+    /**
+     * @brief positionAt Восстанавливает позицию после первых ply ходов журнала.
+     * @param ply Число ходов (не больше moveCount()).
+     * @return Позиция с журналом из этих ходов и тем же радиусом фронтира.
+     */
+    BasicGameLogic positionAt(int ply) const;
+
+    /**
+     * @brief setRules Задаёт правила игры и игрока, играющего чёрными.
+     *
+     * Счётчики пятёрок, кэш оценок линий и (для рэндзю) кэш форм пересчитываются
+     * по текущей позиции. Правила сохраняются при reset().
+     * @param black Игрок чёрными: для рэндзю – тот, у кого есть запрещённые ходы.
+     */
+    void setRules(Rules rules, Player black = Human);
+    Rules getRules() const { return rules; }
+    Player getBlackPlayer() const { return black; }
+
+    // true, если игроку засчитывается длинный ряд (шесть и больше в ряд).
+    bool overlineWins(Player player) const { return !exactFive[player - 1]; }
+
+    // true, если у игрока бывают запрещённые ходы (чёрные в рэндзю).
+    bool hasForbiddenMoves(Player player) const { return rules == Renju && player == black; }
+
+    /**
+     * @brief isForbidden Запрещён ли ход игрока в пустую клетку (row, col).
+     *
+     * Запреты есть только у чёрных в рэндзю: длинный ряд, 4-4 и 3-3, если ход не даёт
+     * ровно пять. Формы линий берутся из кэша, поэтому проверка почти всегда O(1).
+     */
+    bool isForbidden(int row, int col, Player player) const;
+
+    // Форма линии направления dir для хода чёрных в пустую клетку cell (кэш рэндзю, см. RenjuRules).
+    uint16_t renjuShape(int dir, int cell) const { return shapes[dir][cell]; }
+
     // Проверка, выиграл ли игрок, сделав ход в (row, col).
     bool checkWin(int row, int col, Player player) const;
 
     // Проверка всего поля на наличие победителя, возвращает игрока, если кто-то выиграл, иначе None.
+    // Работает за O(1): число линий с пятью в ряд поддерживается инкрементально.
     int checkWinner() const;
 
     // Возвращает список доступных ходов в виде вектора пар (row, col).
     std::vector<std::pair<int, int>> getAvailableMoves() const;
 
+    // Возвращает ходы-кандидаты: пустые клетки рядом с камнями (фронтир).
+    // На пустой доске единственный кандидат – центр поля.
+    std::vector<std::pair<int, int>> getCandidateMoves() const;
+
+    // Число кандидатов во фронтире.
+    int candidateCount() const { return frontierSize; }
+
+    // Клетка фронтира с номером i (0 <= i < candidateCount()) в виде индекса row * BOARD_SIZE + col.
+    int candidateAt(int i) const { return frontier[i]; }
+
+    // Задаёт радиус фронтира (расстояние по Чебышёву, от 1 до MAX_CANDIDATE_RADIUS) и перестраивает его.
+    void setCandidateRadius(int radius);
+    int getCandidateRadius() const { return candidateRadius; }
+
+    // Число камней на доске.
+    int stoneCount() const { return stones; }
+
+    // true, если на доске не осталось пустых клеток.
+    bool isBoardFull() const { return stones == CELL_COUNT; }
+
+    // Оценка позиции по шаблонам на линиях (положительная – в пользу AI), без учёта победы.
+    int evaluation() const { return evaluationScore; }
+
+    // Zobrist-хеш текущей позиции (без учёта очереди хода).
+    uint64_t hash() const { return symmetricHashes[0][0]; }
+
+    // Хеш образа позиции при симметрии symmetry (0 – сама позиция).
+    uint64_t symmetricHash(int symmetry) const { return symmetricHashes[0][symmetry]; }
+
+    /**
+     * @brief canonicalHash Канонический ключ позиции с точки зрения игрока, который ходит.
+     *
+     * Камни side хешируются ключами AI, камни соперника – ключами Human, и из 8 образов
+     * позиции берётся наименьший хеш. Ключ учитывает очередь хода (sideToMoveKey не нужен)
+     * и совпадает для всех симметричных позиций, а также для позиции с переставленными
+     * цветами при другой очереди хода.
+     *
+     * @param side Игрок, который ходит.
+     * @param symmetry Симметрия, переводящая позицию в каноническую (см. transformCell).
+     */
+    uint64_t canonicalHash(Player side, int &symmetry) const;
+
+    /**
+     * @brief symmetryMask Симметрии, оставляющие позицию на месте.
+     * @return Битовая маска: бит s установлен, если образ позиции при симметрии s совпадает с ней
+     *         (бит 0 установлен всегда).
+     */
+    int symmetryMask() const;
+
+    /**
+     * @brief transformCell Образ клетки при симметрии доски.
+     * @param symmetry 0 – тождественная, 1/2/3 – поворот на 90/180/270 градусов,
+     *                 4/5 – отражение слева направо/сверху вниз, 6/7 – отражение
+     *                 относительно главной/побочной диагонали.
+     * @param cell Клетка (row * BOARD_SIZE + col).
+     */
+    static int transformCell(int symmetry, int cell);
+
+    // Ключ, который добавляется к хешу, если ход за минимизирующим игроком (Human).
+    static uint64_t sideToMoveKey();
+
+    // Zobrist-ключ камня игрока player в клетке (row, col).
+    static uint64_t stoneKey(Player player, int row, int col);
+
+    // Битовая маска камней игрока на линии index направления dir (бит i – i-я клетка линии).
+    uint32_t lineMask(Player player, int dir, int index) const;
+
+    // Номер линии направления dir, проходящей через клетку (row, col).
+    static int lineIndex(int dir, int row, int col);
+
+    // Позиция клетки (row, col) на её линии направления dir.
+    static int linePosition(int dir, int row, int col);
+
+    // Длина линии index направления dir.
+    static int lineLength(int dir, int index);
+
+    // Клетка (row * BOARD_SIZE + col) на позиции pos линии index направления dir.
+    static int lineCell(int dir, int index, int pos);
+
     // Игровое поле: двумерный массив, где записаны номера игроков или None.
+    // Только для чтения: изменять поле следует через makeMove/undoMove/reset,
+    // иначе битовые маски рассинхронизируются с массивом.
     int board[BOARD_SIZE][BOARD_SIZE];
+
+private:
+    // Ставит или снимает бит клетки во всех четырёх линиях игрока и обновляет счётчик пятёрок.
+    void toggleStone(int row, int col, Player player);
+
+    // Изменяет счётчики соседства вокруг клетки на delta (+1 при ходе, -1 при отмене).
+    void updateNeighbours(int row, int col, int delta);
+
+    // Добавление и удаление клетки из фронтира за O(1).
+    void addCandidate(int cell);
+    void removeCandidate(int cell);
+
+    // Полностью перестраивает счётчики соседства и фронтир по текущему полю.
+    void rebuildFrontier();
+
+    // Пересчитывает счётчики пятёрок, оценки линий и формы рэндзю по текущему полю.
+    void rebuildLineCaches();
+
+    // Пересчитывает формы рэндзю пустых клеток на линиях через (row, col) в пределах окна формы.
+    void updateShapes(int row, int col);
+
+    // Начальные позиции пятёрок на линии, которые выигрывают для игрока p (0 – Human, 1 – AI).
+    uint32_t winningFives(uint32_t mask, int p) const {
+        return exactFive[p] ? exactFiveStarts(mask) : fiveStarts(mask);
+    }
+
+    uint32_t lines[2][4][LINE_COUNT]; // Битовые маски линий для Human (0) и AI (1).
+    int fiveLines[2];                 // Число линий, на которых у игрока есть пять в ряд.
+    uint64_t symmetricHashes[2][SYMMETRY_COUNT]; // Хеши образов позиции: [0] – цвета как есть, [1] – переставлены.
+    int lineScores[4][LINE_COUNT];    // Кэш оценок линий (AI минус Human).
+    int evaluationScore;              // Сумма оценок всех линий.
+    int stones;                       // Число камней на доске.
+    Rules rules;                      // Правила игры.
+    Player black;                     // Игрок, играющий чёрными.
+    bool exactFive[2];                // Выигрывает только ровно пять в ряд (Human, AI).
+    uint16_t shapes[4][CELL_COUNT];   // Кэш рэндзю: формы линий для хода чёрных в пустую клетку.
+
+    int candidateRadius;                      // Радиус фронтира.
+    uint8_t neighbours[BOARD_SIZE][BOARD_SIZE]; // Число камней в радиусе candidateRadius от клетки.
+    int frontier[CELL_COUNT];                 // Клетки фронтира (индексы row * BOARD_SIZE + col).
+    int frontierIndex[CELL_COUNT];            // Позиция клетки в frontier или -1.
+    int frontierSize;                         // Число клеток во фронтире.
+
+    std::vector<RecordedMove> log;     // Журнал партии.
+    std::vector<RecordedMove> redoLog; // Отменённые ходы (последний отменённый – в конце).
 };
+
+// Размеры доски, для которых движок собран (явные инстанцирования в game-logic.cpp).
+extern template class BasicGameLogic<15>;
+extern template class BasicGameLogic<19>;
+extern template class BasicGameLogic<20>;
+
+// Классическая доска 15x15.
+using GameLogic = BasicGameLogic<15>;
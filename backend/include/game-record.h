@@ -0,0 +1,140 @@
+#pragma once
+/*
+ * game-record.h
+ *
+ * Заголовочный файл сохранения партий на диск: GameArchive (чтение и запись файла партий,
+ * текстовый экспорт) и GameRecorder (потоковая запись партии во время игры).
+ *
+ * Двоичный формат (.gmk) – заголовок и поток байтов:
+ *   заголовок, 16 байт: "GMKSAVE\0", uint16 версия (FORMAT_VERSION, little-endian),
+ *                       uint8 размер доски, 5 байт резерва;
+ *   0..CELL_COUNT-1  – ход в клетку row * BOARD_SIZE + col (игроки чередуются); если клеток
+ *                      больше 240 (доски 19x19, 20x20), ход занимает 2 байта: старший байт
+ *                      номера клетки (меньше GAME_START) и младший;
+ *   GAME_START p     – начало партии, p – игрок, который ходит первым (1 – Human, 2 – AI);
+ *   UNDO             – отмена последнего хода партии;
+ *   GAME_END w       – конец партии, w – победитель (0 – ничья или партия прервана).
+ *
+ * Все партии файла сыграны на доске размера из заголовка.
+ *
+ * Файл только дописывается: каждый ход – один-два байта в конце файла, поэтому при сбое
+ * программы теряется не больше одного хода, а сохранённые партии не переписываются.
+ * Партия без GAME_END (оборванная сбоем) читается как незавершённая.
+ * В одном файле может лежать сколько угодно партий; чтение – один проход по буферу
+ * в памяти, что позволяет быстро загружать тысячи партий для анализа и построения
+ * дебютной книги.
+ *
+ * Текстовый экспорт – одна партия в строке: ходы "row,col" через пробел и комментарий
+ * с результатом. Этот формат принимает gomoku-book-builder --import.
+ */
+
+#include "game-logic.h"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Сохранённая партия.
+ */
+struct SavedGame {
+    int boardSize = GameLogic::BOARD_SIZE;             // Размер доски.
+    GameLogic::Player firstPlayer = GameLogic::Human; // Кто ходит первым.
+    std::vector<GameLogic::RecordedMove> moves;        // Ходы партии.
+    int winner = GameLogic::None; // Победитель (None – ничья или партия не окончена).
+    bool finished = false;        // Партия записана до конца (есть GAME_END).
+
+    // Игрок, который ходит после всех ходов партии.
+    GameLogic::Player sideToMove() const;
+
+    // Позиция после всех ходов партии (с журналом ходов); N должно совпадать с boardSize.
+    template <int N = GameLogic::BOARD_SIZE>
+    BasicGameLogic<N> position() const;
+};
+
+class GameArchive {
+public:
+    static const uint16_t FORMAT_VERSION = 1; // Версия двоичного формата.
+    static const int HEADER_SIZE = 16;        // Размер заголовка в байтах.
+
+    static const int MAX_BOARD_SIZE = 32;     // Наибольший размер доски, который умещается в формат.
+
+    // Служебные байты потока (ходы занимают значения 0..CELL_COUNT-1 или 2 байта, см. выше).
+    static const uint8_t GAME_START = 0xF0;
+    static const uint8_t UNDO = 0xF1;
+    static const uint8_t GAME_END = 0xF2;
+
+    /**
+     * @brief load Читает все партии из двоичного файла.
+     * @param path Путь к файлу.
+     * @param games Прочитанные партии (добавляются в конец).
+     * @param error Описание ошибки, если чтение не удалось.
+     * @return false, если файл не открылся, имеет неверный заголовок или повреждён.
+     *         Неполный служебный байт в самом конце файла (сбой во время записи) ошибкой не считается.
+     */
+    static bool load(const std::string &path, std::vector<SavedGame> &games, std::string &error);
+
+    /**
+     * @brief save Записывает партии в новый двоичный файл (существующий файл перезаписывается).
+     * @return false при ошибке записи или если партии сыграны на досках разного размера.
+     */
+    static bool save(const std::string &path, const std::vector<SavedGame> &games);
+
+    /**
+     * @brief exportText Записывает партии в текстовом виде, по одной в строке.
+     */
+    static bool exportText(const std::string &path, const std::vector<SavedGame> &games);
+
+    // Текстовая запись партии: "7,7 7,8 ... # результат".
+    static std::string toText(const SavedGame &game);
+
+    // Проверяет, что файл начинается с заголовка двоичного формата.
+    static bool isArchive(const std::string &path);
+
+    // Размер доски из заголовка файла партий (0, если это не файл партий).
+    static int archiveBoardSize(const std::string &path);
+
+    // Записывает заголовок двоичного формата.
+    static bool writeHeader(std::FILE *file, int boardSize = GameLogic::BOARD_SIZE);
+};
+
+class GameRecorder {
+public:
+    GameRecorder() = default;
+    ~GameRecorder();
+
+    GameRecorder(const GameRecorder &) = delete;
+    GameRecorder &operator=(const GameRecorder &) = delete;
+
+    /**
+     * @brief open Открывает файл партий для дописывания (создаёт его с заголовком, если файла нет).
+     * @param boardSize Размер доски записываемых партий.
+     * @return false, если файл не открылся, не является файлом партий или хранит партии
+     *         на доске другого размера.
+     */
+    bool open(const std::string &path, int boardSize = GameLogic::BOARD_SIZE);
+
+    // Закрывает файл; незаконченная партия остаётся в нём незавершённой.
+    void close();
+
+    bool isOpen() const { return file != nullptr; }
+
+    // Начинает новую партию.
+    bool beginGame(GameLogic::Player firstPlayer = GameLogic::Human);
+
+    // Дописывает ход текущей партии.
+    bool appendMove(int row, int col);
+
+    // Дописывает отмену последнего хода.
+    bool appendUndo();
+
+    // Завершает партию с победителем winner (None – ничья или партия прервана).
+    bool endGame(int winner);
+
+private:
+    // Дописывает байты и сразу сбрасывает их на диск.
+    bool write(const uint8_t *bytes, std::size_t count);
+
+    std::FILE *file = nullptr; // Файл, открытый для дописывания.
+    int boardSize = GameLogic::BOARD_SIZE; // Размер доски партий файла.
+};
@@ -0,0 +1,25 @@
+#pragma once
+/*
+ * gomoku-engine.h
+ *
+ * Публичный заголовок библиотеки gomoku-engine – игрового движка без зависимости от Qt.
+ * Подключает игровую логику (GameLogic), поиск хода (AlphaBetaAI) и вспомогательные
+ * компоненты: таблицу транспозиций, оценку позиции по шаблонам и поиск
+ * форсированного выигрыша по угрозам (ThreatSolver), статистику поиска (SearchStats)
+ * дебютную книгу (OpeningBook) и сохранение партий на диск (GameArchive, GameRecorder).
+ * Размер доски задаётся параметром шаблонов движка; EngineSession выбирает его во время работы.
+ * Правила (свободный стиль, стандартное гомоку, рэндзю) задаются GameLogic::setRules;
+ * запрещённые ходы рэндзю распознаёт RenjuRules, решения дебюта swap2 принимает Swap2Opening.
+ */
+
+#include "game-logic.h"
+#include "pattern-evaluator.h"
+#include "renju-rules.h"
+#include "transposition-table.h"
+#include "threat-solver.h"
+#include "search-stats.h"
+#include "opening-book.h"
+#include "game-record.h"
+#include "alpha-beta-ai.h"
+#include "swap2-opening.h"
+#include "engine-session.h"
@@ -0,0 +1,155 @@
+#pragma once
+/*
+ * opening-book.h
+ *
+ * Заголовочный файл классов OpeningBook (чтение дебютной книги) и OpeningBookBuilder
+ * (построение книги по партиям).
+ *
+ * В начале партии полный перебор тратит секунды на хорошо известные ходы. Книга хранит
+ * для дебютных позиций заранее выбранные ходы, и AlphaBetaAI::search берёт ход из неё
+ * до любого поиска.
+ *
+ * Позиция в книге задаётся каноническим ключом GameLogic::canonicalHash: камни игрока,
+ * который ходит, и камни его соперника хешируются Zobrist-ключами AI и Human соответственно
+ * (цвет камней не важен), а из 8 симметрий доски берётся та, что даёт наименьший хеш.
+ * Поэтому одна запись обслуживает все повёрнутые и отражённые варианты позиции,
+ * а ход хранится в системе координат канонической симметрии.
+ *
+ * Формат файла (все числа little-endian):
+ *   заголовок, 24 байта: "GMKBOOK\0", uint32 версия (FORMAT_VERSION), uint32 число записей,
+ *                        uint32 размер доски, uint32 резерв;
+ *   записи по 16 байт, отсортированные по ключу, а при равном ключе – по убыванию веса:
+ *                        uint64 ключ, uint16 клетка хода (row * BOARD_SIZE + col),
+ *                        uint16 вес, int16 оценка, uint16 резерв.
+ * Файл отображается в память (mmap / MapViewOfFile) и не читается целиком:
+ * поиск позиции – двоичный поиск прямо по отображённым страницам.
+ *
+ * Книга читается для доски того размера, что записан в заголовке: для позиций другого
+ * размера probe() ничего не находит. OpeningBookBuilder строит книги для доски 15x15.
+ */
+
+#include "game-logic.h"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+class OpeningBook {
+public:
+    static const uint32_t FORMAT_VERSION = 1; // Версия формата файла книги.
+    static const int HEADER_SIZE = 24;        // Размер заголовка в байтах.
+    static const int ENTRY_SIZE = 16;         // Размер записи в байтах.
+
+    /**
+     * @brief Запись книги: ход в позиции с каноническим ключом key.
+     */
+    struct Entry {
+        uint64_t key = 0; // Канонический ключ позиции.
+        int move = -1;    // Клетка хода в канонической системе координат.
+        int weight = 0;   // Вес хода (чем больше, тем чаще ход приводил к успеху).
+        int score = 0;    // Оценка хода с точки зрения ходящего (0, если неизвестна).
+    };
+
+    OpeningBook() = default;
+    ~OpeningBook();
+
+    OpeningBook(const OpeningBook &) = delete;
+    OpeningBook &operator=(const OpeningBook &) = delete;
+
+    /**
+     * @brief open Отображает файл книги в память.
+     * @param path Путь к файлу.
+     * @return false, если файл не открылся или имеет неверный формат; книга при этом пуста.
+     */
+    bool open(const std::string &path);
+
+    // Закрывает файл книги.
+    void close();
+
+    // true, если книга открыта.
+    bool isOpen() const { return data != nullptr; }
+
+    // Число записей в книге.
+    std::size_t size() const { return entryCount; }
+
+    /**
+     * @brief probe Ищет ход для позиции в книге.
+     * @param game Текущее состояние игры.
+     * @param side Игрок, который ходит.
+     * @param move Ход из книги (в координатах game), если он найден.
+     * @return true, если в книге есть допустимый ход для позиции.
+     */
+    template <int N>
+    bool probe(const BasicGameLogic<N> &game, GameLogicBase::Player side, std::pair<int, int> &move) const;
+
+    /**
+     * @brief entries Все записи книги для позиции (по убыванию веса).
+     * @param game Текущее состояние игры.
+     * @param side Игрок, который ходит.
+     * @return Записи с ходами, уже переведёнными в координаты game (row * BOARD_SIZE + col).
+     */
+    template <int N>
+    std::vector<Entry> entries(const BasicGameLogic<N> &game, GameLogicBase::Player side) const;
+
+    // Размер доски, для которой построена книга (0, если книга не открыта).
+    int boardSize() const { return bookBoardSize; }
+
+private:
+    // Запись с номером index из отображённого файла.
+    Entry entryAt(std::size_t index) const;
+
+    const unsigned char *data = nullptr; // Начало отображённого файла.
+    std::size_t length = 0;              // Размер отображения в байтах.
+    std::size_t entryCount = 0;          // Число записей.
+    int bookBoardSize = 0;               // Размер доски из заголовка.
+    void *fileHandle = nullptr;          // Дескрипторы файла и отображения (только Windows).
+    void *mappingHandle = nullptr;
+};
+
+class OpeningBookBuilder {
+public:
+    /**
+     * @brief addMove Учитывает ход move в позиции game.
+     * @param game Позиция перед ходом.
+     * @param side Игрок, который делает ход.
+     * @param move Ход (row, col).
+     * @param weight Добавляемый вес.
+     * @param score Оценка хода с точки зрения side (сохраняется последняя ненулевая).
+     */
+    void addMove(const GameLogic &game, GameLogic::Player side, std::pair<int, int> move, int weight,
+                 int score = 0);
+
+    /**
+     * @brief addGame Учитывает первые maxPlies ходов партии.
+     *
+     * Ходы победителя получают вес 2, ходы ничейной партии – 1, ходы проигравшего
+     * в книгу не попадают.
+     *
+     * @param moves Ходы партии; первый ход делает Human, дальше игроки чередуются.
+     * @param maxPlies Сколько первых ходов партии учитывать.
+     * @return false, если в партии есть недопустимый ход.
+     */
+    bool addGame(const std::vector<std::pair<int, int>> &moves, int maxPlies);
+
+    // Число различных пар (позиция, ход).
+    std::size_t size() const { return moves.size(); }
+
+    /**
+     * @brief save Записывает книгу в файл.
+     * @param path Путь к файлу.
+     * @param minWeight Ходы с меньшим весом не записываются.
+     * @return false при ошибке записи.
+     */
+    bool save(const std::string &path, int minWeight = 1) const;
+
+private:
+    // Накопленный вес и оценка хода.
+    struct Stats {
+        long long weight = 0;
+        int score = 0;
+    };
+
+    std::map<std::pair<uint64_t, int>, Stats> moves; // (канонический ключ, каноническая клетка) -> вес.
+};
@@ -0,0 +1,101 @@
+#pragma once
+/*
+ * pattern-evaluator.h
+ *
+ * Заголовочный файл класса PatternEvaluator – оценки позиции по шаблонам на линиях.
+ *
+ * Оценка позиции раскладывается в сумму оценок отдельных линий (строк, столбцов и диагоналей).
+ * Каждая линия оценивается по её битовым маскам из GameLogic:
+ *   - сплошные цепочки (два, три, четыре в ряд) оцениваются по длине и числу открытых концов,
+ *     так же, как в исходной таблице AlphaBetaAI (открытая тройка, закрытая четвёрка и т.д.);
+ *   - дополнительно распознаются шаблоны с разрывом: разорванная тройка (_X_XX_, _XX_X_)
+ *     и разорванная четвёрка (X_XXX, XX_XX, XXX_X), которые цепочечная оценка не видит.
+ *
+ * Благодаря этому GameLogic хранит оценку каждой линии в кэше и при ходе пересчитывает
+ * только 4 линии, проходящие через изменённую клетку.
+ *
+ * Кроме того, moveThreat определяет, какую угрозу создаёт ход в клетку (пятёрку, четвёрку,
+ * открытую тройку), проверяя только окна линий, проходящие через эту клетку.
+ * Это используется для упорядочивания ходов в поиске.
+ *
+ * Если игроку засчитывается только ровно пять в ряд (GameLogic::overlineWins), длинный ряд
+ * не оценивается, а пятёркой и четвёркой считаются только отрезки, которые не продолжаются
+ * шестым камнем.
+ */
+
+#include <cstdint>
+#include "game-logic.h"
+
+class PatternEvaluator {
+public:
+    // Угроза, создаваемая ходом (по возрастанию силы).
+    enum Threat {
+        NoThreat = 0,  // Ход не создаёт угроз
+        OpenThree = 1, // Открытая тройка (в том числе разорванная): следующим ходом – открытая четвёрка
+        Four = 2,      // Четвёрка: одна клетка до пятёрки
+        OpenFour = 3,  // Открытая четвёрка: две клетки до пятёрки, защиты нет
+        Five = 4       // Пять в ряд – победа
+    };
+
+    static const int FIVE_SCORE = 100000;   // Пять в ряд
+    static const int BROKEN_FOUR_BONUS = 1000; // Надбавка за разорванную четвёрку
+    static const int BROKEN_THREE_BONUS = 900; // Надбавка за открытую разорванную тройку
+
+    /**
+     * @brief chainScore Оценка сплошной цепочки камней (исходная таблица AlphaBetaAI).
+     * @param count Длина цепочки.
+     * @param openEnds Число открытых (пустых) концов цепочки: 0, 1 или 2.
+     * @return Оценка цепочки.
+     */
+    static int chainScore(int count, int openEnds);
+
+    /**
+     * @brief scoreLine Оценивает одну линию с точки зрения владельца маски own.
+     * @param own Камни оцениваемого игрока на линии.
+     * @param opp Камни противника на линии.
+     * @param length Длина линии.
+     * @param brokenPatterns Учитывать ли шаблоны с разрывом.
+     * @param exactFive Длинный ряд (шесть и больше) не выигрывает.
+     * @return Сумма оценок цепочек и шаблонов игрока на линии.
+     */
+    static int scoreLine(uint32_t own, uint32_t opp, int length, bool brokenPatterns = true, bool exactFive = false);
+
+    /**
+     * @brief evaluateLine Оценка линии: оценка камней AI минус оценка камней Human.
+     */
+    template <int N>
+    static int evaluateLine(const BasicGameLogic<N> &game, int dir, int index, bool brokenPatterns = true);
+
+    /**
+     * @brief evaluateBoard Полный пересчёт оценки по всем линиям доски.
+     *
+     * Используется для проверки инкрементального кэша GameLogic::evaluation().
+     * При brokenPatterns == false результат совпадает с эталонной оценкой
+     * AlphaBetaAI::referenceEvaluate для позиций без победителя.
+     */
+    template <int N>
+    static int evaluateBoard(const BasicGameLogic<N> &game, bool brokenPatterns = true);
+
+    /**
+     * @brief moveThreat Сильнейшая угроза, которую создаст ход игрока в пустую клетку.
+     *
+     * Для клетки, где уже стоит камень игрока, – сильнейшая угроза, в которой участвует этот камень.
+     * @param game Текущее состояние игры.
+     * @param row Строка хода.
+     * @param col Столбец хода.
+     * @param player Игрок, делающий ход.
+     * @return Сильнейшая угроза среди 4 линий через клетку.
+     */
+    template <int N>
+    static Threat moveThreat(const BasicGameLogic<N> &game, int row, int col, GameLogicBase::Player player);
+
+    /**
+     * @brief lineThreat Угроза на одной линии, содержащей позицию pos.
+     * @param own Камни игрока на линии (уже с камнем в pos).
+     * @param opp Камни противника на линии.
+     * @param length Длина линии.
+     * @param pos Позиция хода на линии.
+     * @param exactFive Длинный ряд (шесть и больше) не выигрывает.
+     */
+    static Threat lineThreat(uint32_t own, uint32_t opp, int length, int pos, bool exactFive = false);
+};
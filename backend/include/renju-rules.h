@@ -0,0 +1,74 @@
+#pragma once
+/*
+ * renju-rules.h
+ *
+ * Заголовочный файл класса RenjuRules – распознавания запрещённых ходов чёрных в рэндзю.
+ *
+ * Чёрным запрещены ходы, которые создают длинный ряд (шесть и больше), две четвёрки (4-4)
+ * или две открытые тройки (3-3), если ход не даёт ровно пять в ряд. Наивная проверка ставит
+ * камень, заново ищет тройки и четвёрки по 4 линиям и для каждой тройки рекурсивно проверяет,
+ * не запрещён ли ход, превращающий её в открытую четвёрку. В генераторе ходов поиска
+ * (сотни проверок на узел) это слишком дорого.
+ *
+ * Здесь форма линии для хода чёрных в клетку определяется окном из WINDOW клеток в каждую
+ * сторону. Окно кодируется троичным числом (пусто, чёрный камень, белый камень или край
+ * доски), и формы всех 3^10 окон вычисляются один раз. GameLogic хранит формы всех пустых
+ * клеток по 4 направлениям и после хода обновляет только клетки в пределах окна на линиях
+ * через изменённую клетку, а проверка хода объединяет 4 формы из кэша.
+ *
+ * Форма помнит, какие клетки линии превращают тройку в открытую четвёрку. Тройка открытая,
+ * если хотя бы один такой ход сам не запрещён; это проверяется по тому же кэшу и нужно,
+ * только когда ход даёт две тройки сразу. Глубже рекурсия не идёт: тройки у хода,
+ * достраивающего тройку, считаются открытыми без дальнейшей проверки.
+ */
+
+#include "game-logic.h"
+#include <cstdint>
+
+class RenjuRules {
+public:
+    static const int WINDOW = 5; // Клеток окна по каждую сторону от хода.
+
+    // Биты формы линии для хода чёрных в пустую клетку.
+    enum Shape {
+        FiveBit = 1 << 0,     // Ровно пять в ряд
+        OverlineBit = 1 << 1, // Шесть и больше в ряд
+        FourShift = 2,        // Число четвёрок (0–2) в битах 2–3
+        FourMask = 3 << 2,
+        OpenFourBit = 1 << 4, // Четвёрка открытая: пятёрку можно сделать с обеих сторон
+        ThreeShift = 5,       // Биты 5–13: клетки со смещением -4..+4 от хода, превращающие
+        ThreeMask = 0x1FF << 5 // тройку в открытую четвёрку
+    };
+
+    /**
+     * @brief lineShape Форма линии для хода чёрных в пустую клетку pos.
+     * @param black Камни чёрных на линии.
+     * @param white Камни белых на линии.
+     * @param length Длина линии (клетки за её краями считаются занятыми).
+     * @param pos Позиция хода на линии.
+     */
+    static uint16_t lineShape(uint32_t black, uint32_t white, int length, int pos);
+
+    // Число четвёрок, которые создаёт ход на линии.
+    static int fours(uint16_t shape) { return (shape & FourMask) >> FourShift; }
+
+    // Создаёт ли ход на линии тройку (открытую, если не считать запретов на других линиях).
+    static bool isThree(uint16_t shape) { return (shape & ThreeMask) != 0; }
+
+    /**
+     * @brief isForbidden Запрещён ли ход чёрных в пустую клетку (row, col).
+     *
+     * Формы берутся из кэша game (GameLogic::renjuShape); при двух тройках проверяется,
+     * открыты ли они (см. описание файла).
+     */
+    template <int N>
+    static bool isForbidden(const BasicGameLogic<N> &game, int row, int col);
+
+private:
+    /**
+     * @brief openThree Можно ли превратить тройку в открытую четвёрку разрешённым ходом.
+     * @param shape Форма линии dir для хода в (row, col).
+     */
+    template <int N>
+    static bool openThree(const BasicGameLogic<N> &game, int row, int col, int dir, uint16_t shape);
+};
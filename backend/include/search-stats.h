@@ -0,0 +1,76 @@
+#pragma once
+/*
+ * search-stats.h
+ *
+ * Заголовочный файл структуры SearchStats – статистики одного поиска AlphaBetaAI.
+ *
+ * Статистика возвращается вместе с ходом в SearchResult::stats и подходит для строки
+ * состояния интерфейса или журнала. Время итераций и главный вариант собираются всегда
+ * (раз за итерацию), а счётчики внутри дерева поиска (оценки, обращения к таблице
+ * транспозиций, отсечения по номеру хода, максимальная глубина) – только если движок
+ * собран с GOMOKU_SEARCH_STATS (опция CMake). Без неё эти счётчики не компилируются
+ * вовсе и остаются нулевыми, а расположение полей структуры от опции не зависит.
+ *
+ * Время итераций и главный вариант хранятся в массивах фиксированной ёмкости, чтобы
+ * статистика не выделяла память в куче во время поиска.
+ */
+
+#include <string>
+#include <utility>
+
+struct SearchStats {
+#ifdef GOMOKU_SEARCH_STATS
+    static constexpr bool enabled = true;  // Счётчики внутри дерева поиска собираются.
+#else
+    static constexpr bool enabled = false; // Собираются только время итераций и главный вариант.
+#endif
+
+    static const int CUTOFF_BUCKETS = 8; // Отсечения на ходах 1..7 считаются отдельно, дальше – вместе.
+    static const int MAX_ITERATIONS = 64; // Наибольшее число итераций (не меньше предельной глубины поиска).
+    static const int MAX_PV_LENGTH = 64;  // Наибольшая длина главного варианта.
+
+    long long nodes = 0;       // Посещённые узлы (во всех потоках).
+    long long evaluations = 0; // Вызовы оценочной функции.
+    long long ttProbes = 0;    // Обращения к таблице транспозиций.
+    long long ttHits = 0;      // Из них найденные записи.
+    long long cutoffsByIndex[CUTOFF_BUCKETS] = {}; // Бета-отсечения по номеру хода в узле.
+    long long researches = 0;  // Повторные поиски PVS и окон стремления после выхода за окно.
+    long long reductions = 0;  // Ходы, искавшиеся с сокращённой глубиной (LMR).
+    long long reductionResearches = 0; // Из них найденные заново на полную глубину.
+    long long futilityPrunes = 0;      // Тихие ходы, отброшенные по оценке у листьев.
+    long long nullMoveCutoffs = 0;     // Отсечения по нулевому ходу.
+    long long quiescenceNodes = 0;     // Узлы продления угроз на горизонте (входят в nodes).
+    int maxPly = 0;            // Наибольшее расстояние от корня, достигнутое поиском.
+    int iterations = 0;        // Число записей в iterationTimeMs.
+    long long iterationTimeMs[MAX_ITERATIONS] = {}; // Время от начала поиска до конца каждой итерации.
+    int pvLength = 0;          // Число ходов в pv.
+    std::pair<int, int> pv[MAX_PV_LENGTH]; // Главный вариант (row, col) начиная с хода из корня.
+
+    // Сбрасывает всю статистику.
+    void clear();
+
+    // Запоминает время конца очередной итерации (сверх MAX_ITERATIONS итераций не запоминается).
+    void addIteration(long long timeMs);
+
+    // Записывает главный вариант из count ходов (обрезается до MAX_PV_LENGTH).
+    void setPv(const std::pair<int, int> *moves, int count);
+
+    // Добавляет счётчики другого потока поиска (время итераций и вариант не изменяются).
+    void merge(const SearchStats &other);
+
+    // Общее число бета-отсечений.
+    long long betaCutoffs() const;
+
+    // Доля попаданий в таблицу транспозиций (0..1).
+    double ttHitRate() const;
+
+    // Доля отсечений на первом ходе узла (0..1).
+    double firstMoveCutoffRate() const;
+
+    /**
+     * @brief summary Краткое описание статистики одной строкой.
+     *
+     * Счётчики, которые не собирались (движок без GOMOKU_SEARCH_STATS), не выводятся.
+     */
+    std::string summary() const;
+};
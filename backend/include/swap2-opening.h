@@ -0,0 +1,61 @@
+#pragma once
+/*
+ * swap2-opening.h
+ *
+ * Заголовочный файл класса Swap2Opening – решений движка в дебютном протоколе swap2.
+ *
+ * Swap2 уравнивает преимущество первого хода:
+ *   1. первый игрок ставит три камня (чёрный, белый, чёрный);
+ *   2. второй игрок выбирает: играть белыми и поставить 4-й камень, взять чёрные
+ *      или поставить ещё два камня (белый и чёрный) и отдать выбор цвета первому;
+ *   3. в последнем случае первый игрок выбирает цвет; белыми он ставит 6-й камень.
+ *
+ * Во всех точках выбора ходят белые, поэтому решение принимается по оценке поиска за белых:
+ * заметный перевес одной стороны – движок берёт её цвет, примерное равенство – ставит ещё два
+ * камня так, чтобы позиция осталась равной. Предлагая три камня, движок перебирает
+ * 26 стандартных дебютов (чёрный в центре, белый рядом по прямой или по диагонали,
+ * второй чёрный в квадрате 5x5 вокруг центра) и выбирает самый равный.
+ */
+
+#include "alpha-beta-ai.h"
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Решение движка в swap2.
+ */
+struct Swap2Decision {
+    enum Action {
+        PlaceOpening, // Поставлены три камня дебюта (чёрный, белый, чёрный)
+        PlayWhite,    // Движок играет белыми и ставит очередной белый камень
+        TakeBlack,    // Движок берёт чёрные (SWAP), ход за белыми соперника
+        PlaceTwo      // Поставлены белый и чёрный камни, цвет выбирает соперник
+    };
+
+    Action action = PlaceOpening;
+    std::vector<std::pair<int, int>> stones; // Камни, которые ставит движок, по порядку.
+    int score = 0;                           // Оценка поиска за белых в позиции, по которой принято решение.
+};
+
+class Swap2Opening {
+public:
+    // Перевес (в единицах оценки), при котором движок сразу берёт цвет, а не ставит ещё два камня.
+    static const int BALANCE_MARGIN = 500;
+
+    // Сколько самых равных по статической оценке чёрных камней проверяется поиском (PlaceTwo).
+    static const int BALANCE_CANDIDATES = 4;
+
+    /**
+     * @brief decide Принимает решение swap2 для позиции из stones.
+     * @param game Позиция заменяется позицией после решения (с журналом партии): камни движка – AI,
+     *             правила сохраняются, а чёрными назначается тот, кем движок будет играть
+     *             (после PlaceOpening и PlaceTwo – чёрными в предположении, что следующим ходит
+     *             соперник; если цвет он выбирает иначе, вызывающий код переназначает чёрных).
+     * @param ai Поисковик.
+     * @param stones Камни на доске по порядку ходов (чёрный, белый, чёрный, ...): 0, 3 или 5.
+     * @param limits Ограничения на всё решение; лимит времени делится между поисками.
+     */
+    template <int N>
+    static Swap2Decision decide(BasicGameLogic<N> &game, BasicAlphaBetaAI<N> &ai,
+                                const std::vector<std::pair<int, int>> &stones, const SearchLimits &limits);
+};
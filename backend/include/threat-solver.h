@@ -0,0 +1,163 @@
+#pragma once
+/*
+ * threat-solver.h
+ *
+ * Заголовочный файл класса ThreatSolver – поиска форсированного выигрыша по угрозам.
+ *
+ * Полный перебор AlphaBetaAI успевает заглянуть лишь на несколько ходов вперёд, а форсированные
+ * выигрыши в гомоку часто состоят из длинной серии угроз (10–20 полуходов). Поиск по угрозам
+ * рассматривает только атакующие ходы и вынужденные защиты, поэтому дерево остаётся узким:
+ *   - VCF (victory by continuous fours) – атакующий ставит только четвёрки, у защищающегося
+ *     каждый раз ровно одна защита – клетка, замыкающая пятёрку;
+ *   - VCT (victory by continuous threats) – атакующий ставит четвёрки и открытые тройки;
+ *     защитой от тройки считается любая клетка её линий, где атакующий получил бы четвёрку,
+ *     а также любая контратакующая четвёрка защищающегося.
+ *
+ * Если атакующему нужно закрыть четвёрку противника, он обязан сходить в клетку пятёрки,
+ * и продолжать атаку можно, только если этот ход сам является угрозой. Поэтому найденный
+ * выигрыш действительно форсированный, хотя часть выигрышей (с "тихими" ходами) не находится.
+ *
+ * Поиск ограничен по глубине, числу узлов и времени; доказанные проигрыши атаки
+ * запоминаются по каноническому Zobrist-ключу позиции (общему для симметричных позиций)
+ * в таблице фиксированного размера.
+ *
+ * Списки ходов каждого уровня перебора, таблица проигрышей и выигрышная серия хранятся
+ * в решателе и переиспользуются, поэтому после первого поиска память в куче не выделяется.
+ *
+ * Состояние поиска от размера доски не зависит, поэтому размер – параметр шаблона
+ * только у методов поиска (solve и др.), а не у класса.
+ */
+
+#include "game-logic.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Ограничения поиска по угрозам.
+ */
+struct ThreatLimits {
+    int maxDepth = 20;           // Максимальное число ходов атакующего в выигрышной серии.
+    long long maxNodes = 200000; // Лимит узлов (0 – без ограничения).
+    int timeLimitMs = 0;         // Лимит времени в миллисекундах (0 – без ограничения).
+};
+
+/**
+ * @brief Результат поиска по угрозам.
+ */
+struct ThreatResult {
+    bool found = false;   // Найден форсированный выигрыш (серия – ThreatSolver::line()).
+    long long nodes = 0;  // Число посещённых узлов.
+    bool aborted = false; // Поиск прерван по лимиту узлов, времени или по запросу.
+};
+
+class ThreatSolver {
+public:
+    // Вид поиска.
+    enum Mode {
+        VCF = 0, // Только четвёрки
+        VCT = 1  // Четвёрки и открытые тройки
+    };
+
+    /**
+     * @brief solve Ищет форсированный выигрыш игрока attacker, который сейчас ходит.
+     * @param game Текущее состояние игры (изменяется во время поиска и восстанавливается).
+     * @param attacker Атакующий игрок.
+     * @param mode VCF или VCT.
+     * @param limits Ограничения поиска.
+     * @return Результат поиска; найденную выигрышную серию возвращает line().
+     */
+    template <int N>
+    ThreatResult solve(BasicGameLogic<N> &game, GameLogicBase::Player attacker, Mode mode,
+                       const ThreatLimits &limits);
+
+    /**
+     * @brief line Выигрышная серия последнего поиска, нашедшего выигрыш.
+     *
+     * Ход атакующего, защита, ход атакующего... Серия хранится в решателе и действительна
+     * до следующего вызова solve, если тот вернул found.
+     */
+    const std::vector<std::pair<int, int>> &line() const { return frames[0].line; }
+
+    /**
+     * @brief requestStop Просит прервать текущий поиск (потокобезопасно).
+     */
+    void requestStop() { stopRequested.store(true, std::memory_order_relaxed); }
+
+    // Сбрасывает запрос на остановку перед новым поиском.
+    void clearStopRequest() { stopRequested.store(false, std::memory_order_relaxed); }
+
+private:
+    /**
+     * @brief attack Ход атакующего: есть ли выигрыш не более чем за depth угроз.
+     * @param ply Уровень перебора; при успехе выигрышная серия из позиции – в frames[ply].line.
+     */
+    template <int N>
+    bool attack(BasicGameLogic<N> &game, int depth, int ply);
+
+    /**
+     * @brief defend Ответ защищающегося на только что созданную угрозу атакующего.
+     * @param threat Ход атакующего, создавший угрозу.
+     * @return true, если атакующий выигрывает при любой защите.
+     */
+    template <int N>
+    bool defend(BasicGameLogic<N> &game, std::pair<int, int> threat, int depth, int ply);
+
+    // Добавляет в defences пустые клетки не дальше radius по 4 линиям через (row, col), где любой
+    // из игроков получил бы четвёрку, а защищающийся может сходить; около камней защищающегося
+    // (player == defender) – только клетки его четвёрок. Каждая клетка проверяется за узел один раз (seen).
+    template <int N>
+    void lineDefences(const BasicGameLogic<N> &game, int row, int col, int radius, GameLogicBase::Player player,
+                      std::vector<std::pair<int, std::pair<int, int>>> &defences);
+
+    // Пустые клетки, ход в которые даёт игроку пятёрку (записываются в cells).
+    template <int N>
+    void fiveCells(const BasicGameLogic<N> &game, GameLogicBase::Player player,
+                   std::vector<std::pair<int, int>> &cells) const;
+
+    // Позиция уже проверена без выигрыша атаки на глубину не меньше depth.
+    bool isFailed(uint64_t key, int depth) const;
+
+    // Запоминает, что из позиции нет выигрыша атаки на глубину depth.
+    void storeFailed(uint64_t key, int depth);
+
+    // Учитывает очередной узел; возвращает true, если поиск нужно прервать.
+    bool checkStop();
+
+    GameLogicBase::Player attacker = GameLogicBase::AI;    // Атакующий игрок.
+    GameLogicBase::Player defender = GameLogicBase::Human; // Защищающийся игрок.
+    Mode mode = VCF;          // Вид поиска.
+    ThreatLimits limits;      // Ограничения текущего поиска.
+    long long nodes = 0;      // Число посещённых узлов.
+    bool stopped = false;     // Поиск прерван.
+    std::atomic<bool> stopRequested{false}; // Внешний запрос на остановку.
+    std::chrono::steady_clock::time_point startTime; // Время начала поиска.
+
+    /**
+     * @brief Списки ходов одного уровня перебора (ply): память сохраняется между поисками.
+     */
+    struct Frame {
+        std::vector<std::pair<int, int>> fives;         // Клетки пятёрки атакующего.
+        std::vector<std::pair<int, int>> opponentFives; // Клетки пятёрки защищающегося (в attack).
+        std::vector<std::pair<int, std::pair<int, int>>> moves; // Угрозы (с силой) или защиты.
+        std::vector<std::pair<int, int>> line;          // Выигрышная серия из позиции уровня.
+    };
+    std::vector<Frame> frames; // Уровни перебора: attack на чётных ply, defend на нечётных.
+
+    /**
+     * @brief Запись таблицы проигрышей атаки.
+     */
+    struct FailedEntry {
+        uint64_t key = 0;        // Канонический ключ позиции.
+        uint32_t generation = 0; // Номер поиска, в котором сделана запись (старые записи не действуют).
+        int depth = 0;           // Проверенная глубина.
+    };
+    static const int FAILED_TABLE_BITS = 15;
+    std::vector<FailedEntry> failed; // Позиции без выигрыша атаки, индекс – младшие биты ключа.
+    uint32_t generation = 0;         // Номер текущего поиска.
+
+    std::vector<uint32_t> seen; // Клетки, просмотренные при поиске защит: номер узла (seenStamp).
+    uint32_t seenStamp = 0;     // Номер текущего узла defend.
+};
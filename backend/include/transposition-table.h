@@ -0,0 +1,85 @@
+#pragma once
+/*
+ * transposition-table.h
+ *
+ * Заголовочный файл класса TranspositionTable – таблицы транспозиций фиксированного размера.
+ *
+ * Таблица запоминает результаты поиска для позиций, встреченных ранее (по Zobrist-хешу):
+ * глубину, оценку, тип границы (точная / нижняя / верхняя) и лучший ход.
+ * Одна и та же позиция в гомоку достигается множеством порядков ходов, поэтому
+ * повторный поиск таких позиций можно пропустить.
+ *
+ * Таблица рассчитана на одновременный доступ из нескольких потоков без блокировок:
+ * каждая запись хранится как два атомарных 64-битных слова (ключ XOR данные и данные).
+ * Если запись была частично перезаписана другим потоком, проверка ключа не проходит
+ * и запись просто считается отсутствующей.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+class TranspositionTable {
+public:
+    // Тип сохранённой оценки.
+    enum Bound {
+        NoBound = 0, // Запись пуста
+        Exact = 1,   // Точная оценка
+        Lower = 2,   // Нижняя граница (произошло отсечение по beta)
+        Upper = 3    // Верхняя граница (ни один ход не улучшил alpha)
+    };
+
+    // Распакованная запись таблицы.
+    struct Entry {
+        int score;   // Оценка позиции
+        int depth;   // Глубина поиска, на которой получена оценка
+        Bound bound; // Тип оценки
+        int move;    // Лучший ход как индекс клетки (row * BOARD_SIZE + col) или -1
+    };
+
+    /**
+     * @brief TranspositionTable Создаёт таблицу заданного размера.
+     * @param sizeMb Размер таблицы в мегабайтах (округляется вниз до степени двойки записей).
+     */
+    explicit TranspositionTable(std::size_t sizeMb = 16);
+
+    // Изменяет размер таблицы; содержимое при этом теряется.
+    void resize(std::size_t sizeMb);
+
+    // Очищает все записи.
+    void clear();
+
+    // Начало нового поиска: записи прошлых поисков получают меньший приоритет при замещении.
+    void newSearch();
+
+    /**
+     * @brief probe Ищет запись для позиции.
+     * @param key Хеш позиции.
+     * @param entry Найденная запись.
+     * @return true, если запись найдена.
+     */
+    bool probe(uint64_t key, Entry &entry) const;
+
+    /**
+     * @brief store Сохраняет результат поиска позиции.
+     * @param key Хеш позиции.
+     * @param score Оценка.
+     * @param depth Глубина поиска.
+     * @param bound Тип оценки.
+     * @param move Лучший ход (индекс клетки) или -1.
+     */
+    void store(uint64_t key, int score, int depth, Bound bound, int move);
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> check; // key ^ data – для проверки целостности записи
+        std::atomic<uint64_t> data;  // Упакованные поля записи
+    };
+
+    static uint64_t pack(int score, int depth, Bound bound, int move, uint8_t generation);
+
+    std::unique_ptr<Slot[]> slots; // Массив записей (размер – степень двойки)
+    std::size_t mask = 0;          // Маска индекса: число записей - 1
+    uint8_t generation = 0;        // Номер текущего поиска (6 бит)
+};
@@ -1,17 +1,183 @@
 #include "../include/alpha-beta-ai.h"
+#include "../include/pattern-evaluator.h"
 #include <algorithm>
-#include <limits>
+#include <thread>
 
 // Константная оценка выигрыша – большой балл для мгновенной победы.
-static const int WIN_SCORE = 100000;
+static const int WIN_SCORE = PatternEvaluator::FIVE_SCORE;
 
-AlphaBetaAI::AlphaBetaAI() {
-    // Дополнительная инициализация не требуется.
+// Граница окна поиска, заведомо больше любой оценки; в отличие от INT_MIN её можно менять в знаке.
+static const int INFINITE_SCORE = 1000000000;
+
+// Доля лимита времени на оба поиска по угрозам (VCF и VCT вместе): 1/8.
+static const int THREAT_TIME_DIVISOR = 8;
+
+// Начальная полуширина окна стремления: порядка оценки одной открытой тройки или закрытой четвёрки.
+static const int ASPIRATION_WINDOW = 1000;
+
+// Выигрыш по угрозам, найденный продлением на горизонте (своя открытая четвёрка): почти наверняка,
+// но встречные четвёрки противника не проверялись, поэтому это не WIN_SCORE и поиск не останавливает.
+static const int THREAT_WIN_SCORE = WIN_SCORE / 2;
+
+// Сокращение поздних ходов (LMR): с какой глубины узла, сколько первых ходов не сокращается
+// и с какого хода сокращение двойное.
+static const int LMR_MIN_DEPTH = 3;
+static const int LMR_FULL_MOVES = 3;
+static const int LMR_DEEP_MOVES = 12;
+
+// Отсечение по оценке: до какой глубины и запас по глубине. Тихий ход (без троек и четвёрок)
+// поднимает оценку не больше чем на несколько открытых двоек.
+static const int FUTILITY_DEPTH = 2;
+static const int FUTILITY_MARGIN[FUTILITY_DEPTH + 1] = {0, 500, 1000};
+
+// Нулевой ход: с какой глубины узла и на сколько сокращается поиск после пропуска хода.
+static const int NULL_MOVE_MIN_DEPTH = 4;
+static const int NULL_MOVE_REDUCTION = 2;
+
+// Таблица транспозиций хранит ходы в системе координат канонической симметрии позиции
+// (Game::canonicalHash); эти функции переводят ход туда и обратно.
+template <int N>
+static int toCanonical(int cell, int symmetry) {
+    return cell < 0 ? -1 : BasicGameLogic<N>::transformCell(symmetry, cell);
+}
+
+template <int N>
+static int fromCanonical(int cell, int symmetry) {
+    return cell < 0 ? -1 : BasicGameLogic<N>::transformCell(GameLogicBase::inverseSymmetry(symmetry), cell);
+}
+
+/**
+ * @brief removeSymmetricMoves Оставляет по одному ходу из каждой группы симметричных ходов.
+ *
+ * Если позиция переходит в себя при какой-то симметрии доски (обычно в самом начале
+ * партии), ходы, переходящие друг в друга при этой симметрии, равноценны, и в корне
+ * достаточно искать один из них.
+ */
+template <int N, typename MoveList>
+static void removeSymmetricMoves(const BasicGameLogic<N> &game, MoveList &moves) {
+    int mask = game.symmetryMask();
+    if (mask == 1)
+        return;
+    auto isRepresentative = [mask](int cell) {
+        for (int s = 1; s < GameLogicBase::SYMMETRY_COUNT; s++) {
+            if ((mask & (1 << s)) && BasicGameLogic<N>::transformCell(s, cell) < cell)
+                return false;
+        }
+        return true;
+    };
+    moves.count = int(std::remove_if(moves.cells, moves.cells + moves.count,
+                                     [&](int cell) { return !isRepresentative(cell); }) -
+                      moves.cells);
+}
+
+// Ход-угроза или блок угрозы противника: такие ходы выборочный поиск не сокращает и не отбрасывает.
+template <int N>
+static bool isForcingMove(const BasicGameLogic<N> &game, std::pair<int, int> move, GameLogicBase::Player side) {
+    GameLogicBase::Player opponent = (side == GameLogicBase::AI) ? GameLogicBase::Human : GameLogicBase::AI;
+    return PatternEvaluator::moveThreat(game, move.first, move.second, side) != PatternEvaluator::NoThreat ||
+           PatternEvaluator::moveThreat(game, move.first, move.second, opponent) != PatternEvaluator::NoThreat;
+}
+
+// Угроза, в которой участвует камень игрока side в клетке cell (-1 – нулевой ход, угрозы нет).
+template <int N>
+static PatternEvaluator::Threat stoneThreat(const BasicGameLogic<N> &game, int cell, GameLogicBase::Player side) {
+    return cell < 0 ? PatternEvaluator::NoThreat : PatternEvaluator::moveThreat(game, cell / N, cell % N, side);
+}
+
+// Счётчики статистики внутри дерева поиска компилируются только с GOMOKU_SEARCH_STATS.
+#ifdef GOMOKU_SEARCH_STATS
+#define SEARCH_STAT(statement) statement
+#else
+#define SEARCH_STAT(statement) ((void)0)
+#endif
+
+template <int N>
+BasicAlphaBetaAI<N>::BasicAlphaBetaAI()
+    : tt(std::make_shared<TranspositionTable>()) {
+    // Таблица транспозиций создаётся с размером по умолчанию.
+    resetOrdering();
+}
+
+template <int N>
+BasicAlphaBetaAI<N>::BasicAlphaBetaAI(std::shared_ptr<TranspositionTable> sharedTable)
+    : tt(std::move(sharedTable)) {
+    resetOrdering();
+    worker = std::thread([this]() { workerLoop(); });
+}
+
+template <int N>
+BasicAlphaBetaAI<N>::~BasicAlphaBetaAI() {
+    if (!worker.joinable())
+        return;
+    requestStop();
+    {
+        std::lock_guard<std::mutex> lock(workerMutex);
+        workerExit = true;
+    }
+    workerSignal.notify_all();
+    worker.join();
+}
+
+template <int N>
+void BasicAlphaBetaAI<N>::setThreadCount(int threads) {
+    threadCount = std::max(1, threads);
+    helpers.clear();
+    for (int i = 1; i < threadCount; i++)
+        helpers.emplace_back(new BasicAlphaBetaAI(tt));
+}
+
+template <int N>
+void BasicAlphaBetaAI<N>::setHashSize(std::size_t sizeMb) {
+    tt->resize(sizeMb);
+}
+
+template <int N>
+void BasicAlphaBetaAI<N>::clearHash() {
+    tt->clear();
+}
+
+template <int N>
+void BasicAlphaBetaAI<N>::setOpeningBook(std::shared_ptr<const OpeningBook> book) {
+    openingBook = std::move(book);
+}
+
+template <int N>
+void BasicAlphaBetaAI<N>::requestStop() {
+    stopRequested.store(true, std::memory_order_relaxed);
+    threatSolver.requestStop();
+}
+
+template <int N>
+void BasicAlphaBetaAI<N>::clearStopRequest() {
+    stopRequested.store(false, std::memory_order_relaxed);
+    threatSolver.clearStopRequest();
+}
+
+template <int N>
+void BasicAlphaBetaAI<N>::setProgressCallback(std::function<void(const SearchResult &)> callback) {
+    progressCallback = std::move(callback);
 }
 
 /**
  * @brief evaluate Оценивает данную позицию.
  *
+ * Победа определяется по счётчикам GameLogic, а оценка без победителя берётся
+ * из кэша линий Game::evaluation(), поэтому вызов не требует обхода доски.
+ */
+template <int N>
+int BasicAlphaBetaAI<N>::evaluate(Game &game) {
+    SEARCH_STAT(stats.evaluations++);
+    int winner = game.checkWinner();
+    if (winner == Game::AI)
+        return WIN_SCORE;
+    else if (winner == Game::Human)
+        return -WIN_SCORE;
+    return game.evaluation();
+}
+
+/**
+ * @brief referenceEvaluate Эталонная оценка позиции полным обходом доски.
+ *
  * Если кто-либо выигрывает, возвращается WIN_SCORE или -WIN_SCORE.
  * Если нет, для каждой заполненной клетки, для которой не учитывается уже подсчитанная цепочка,
  * анализируются 4 направления (вправо, вниз, диагональ вниз-вправо, диагональ вверх-вправо).
@@ -21,15 +187,16 @@ AlphaBetaAI::AlphaBetaAI() {
  * @param game Текущее состояние игры.
  * @return Оценка позиции (положительный балл – в пользу ИИ, отрицательный – в пользу игрока).
  */
-int AlphaBetaAI::evaluate(GameLogic &game) {
+template <int N>
+int BasicAlphaBetaAI<N>::referenceEvaluate(const Game &game) {
     int winner = game.checkWinner();
-    if (winner == GameLogic::AI)
+    if (winner == Game::AI)
         return WIN_SCORE;
-    else if (winner == GameLogic::Human)
+    else if (winner == Game::Human)
         return -WIN_SCORE;
 
     int score = 0;
-    const int BOARD_SIZE = GameLogic::BOARD_SIZE;
+    const int BOARD_SIZE = N;
     
     // Определяем 4 направления: вправо, вниз, диагональ вниз-вправо, диагональ вверх-вправо.
     int dx[4] = { 0, 1, 1, -1 };
@@ -38,7 +205,7 @@ int AlphaBetaAI::evaluate(GameLogic &game) {
     for (int i = 0; i < BOARD_SIZE; i++){
         for (int j = 0; j < BOARD_SIZE; j++){
             int piece = game.board[i][j];
-            if (piece == GameLogic::None)
+            if (piece == Game::None)
                 continue;
             
             for (int d = 0; d < 4; d++){
@@ -64,12 +231,12 @@ int AlphaBetaAI::evaluate(GameLogic &game) {
                 // Определяем число открытых концов цепочки.
                 int openEnds = 0;
                 if (r >= 0 && r < BOARD_SIZE && c >= 0 && c < BOARD_SIZE &&
-                    game.board[r][c] == GameLogic::None)
+                    game.board[r][c] == Game::None)
                     openEnds++;
                 int before_r = i - dx[d];
                 int before_c = j - dy[d];
                 if (before_r >= 0 && before_r < BOARD_SIZE && before_c >= 0 && before_c < BOARD_SIZE &&
-                    game.board[before_r][before_c] == GameLogic::None)
+                    game.board[before_r][before_c] == Game::None)
                     openEnds++;
                 
                 int chainScore = 0;
@@ -89,7 +256,7 @@ int AlphaBetaAI::evaluate(GameLogic &game) {
                     chainScore = 10;
                 }
                 
-                if (piece == GameLogic::AI)
+                if (piece == Game::AI)
                     score += chainScore;
                 else
                     score -= chainScore;
@@ -100,54 +267,497 @@ int AlphaBetaAI::evaluate(GameLogic &game) {
 }
 
 /**
- * @brief alphaBeta Рекурсивно ищет оптимальную оценку позиции с альфа-бета отсечением.
+ * @brief checkStop Учитывает очередной узел и проверяет, не истёк ли лимит времени.
+ *
+ * Часы и внешний запрос на остановку опрашиваются раз в 1024 узла. По времени поиск
+ * прерывается только после того, как завершена хотя бы одна итерация, чтобы всегда был готов ход;
+ * внешний запрос прерывает поиск сразу (его результат всё равно не нужен).
+ */
+template <int N>
+bool BasicAlphaBetaAI<N>::checkStop() {
+    if (stopped)
+        return true;
+    nodes++;
+    if ((nodes & 1023) == 0) {
+        publishedNodes.store(nodes, std::memory_order_relaxed);
+        if (stopRequested.load(std::memory_order_relaxed))
+            stopped = true;
+        else if (timeLimitMs > 0 && completedDepth > 0 && elapsedMs() >= timeLimitMs)
+            stopped = true;
+    }
+    return stopped;
+}
+
+template <int N>
+long long BasicAlphaBetaAI<N>::elapsedMs() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now() - startTime).count();
+}
+
+/**
+ * @brief negamax Рекурсивный поиск с альфа-бета отсечением в форме negamax.
+ *
+ * Оценка считается с точки зрения игрока Side, который ходит в позиции: оценка той же
+ * позиции для противника – это она же с обратным знаком. Поэтому один цикл обслуживает
+ * обоих игроков, а сторона – параметр шаблона, и проверки "чей ход" в цикле не остаётся.
+ * Все эвристики и отсечения поиска подключаются сюда и в searchMove.
+ *
+ * Выборочный поиск (см. SearchLimits): нулевой ход проверяется до генерации ходов,
+ * отсечение по оценке и LMR применяются к тихим ходам из конца списка – после хода
+ * из таблицы, угроз и ходов-убийц (orderMoves возвращает, где они начинаются).
+ * Отброшенный по оценке ход считается не лучше currentScore + запас, поэтому узел,
+ * где все ходы отброшены, сохраняется в таблице как верхняя граница.
+ *
  * @param game Текущее состояние игры.
  * @param depth Глубина поиска.
- * @param alpha Текущее значение альфа.
- * @param beta Текущее значение бета.
- * @param maximizingPlayer Если true – максимизируем оценку (ход ИИ), иначе – минимизируем.
- * @return Полученная оценка позиции.
- */
-int AlphaBetaAI::alphaBeta(GameLogic &game, int depth, int alpha, int beta, bool maximizingPlayer) {
-    int currentScore = evaluate(game);
-    if (depth == 0 || currentScore >= WIN_SCORE || currentScore <= -WIN_SCORE)
+ * @param ply Расстояние от корня.
+ * @param alpha Нижняя граница окна (с точки зрения Side).
+ * @param beta Верхняя граница окна (с точки зрения Side).
+ * @return Оценка позиции для Side (не имеет смысла, если поиск был прерван).
+ */
+template <int N>
+template <GameLogicBase::Player Side>
+int BasicAlphaBetaAI<N>::negamax(Game &game, int depth, int ply, int alpha, int beta) {
+    if (checkStop())
+        return 0;
+    SEARCH_STAT(if (ply > stats.maxPly) stats.maxPly = ply);
+
+    // Проверяем таблицу транспозиций: если позиция уже исследована на достаточную глубину,
+    // её оценка сразу используется или сужает окно поиска.
+    // Ключ общий для всех симметричных позиций (см. Game::canonicalHash).
+    int symmetry;
+    uint64_t key = game.canonicalHash(Side, symmetry);
+    int alphaOrig = alpha;
+    int betaOrig = beta;
+    int ttMove = -1;
+    TranspositionTable::Entry entry;
+    SEARCH_STAT(stats.ttProbes++);
+    if (tt->probe(key, entry)) {
+        SEARCH_STAT(stats.ttHits++);
+        ttMove = fromCanonical<N>(entry.move, symmetry);
+        if (entry.depth >= depth) {
+            if (entry.bound == TranspositionTable::Exact)
+                return entry.score;
+            if (entry.bound == TranspositionTable::Lower)
+                alpha = std::max(alpha, entry.score);
+            else if (entry.bound == TranspositionTable::Upper)
+                beta = std::min(beta, entry.score);
+            if (beta <= alpha)
+                return entry.score;
+        }
+    }
+
+    constexpr GameLogicBase::Player Opponent = (Side == Game::AI) ? Game::Human : Game::AI;
+    int currentScore = (Side == Game::AI) ? evaluate(game) : -evaluate(game);
+    if (currentScore >= WIN_SCORE || currentScore <= -WIN_SCORE)
+        return currentScore;
+    if (depth == 0) {
+        // На горизонте угрозы продлеваются, если последний ход противника сделал четвёрку
+        // или свой предыдущий ход – открытую тройку или четвёрку, которые не закрыты.
+        if (quiescenceNodeLimit > 0 &&
+            (stoneThreat(game, plyMoves[ply - 1], Opponent) >= PatternEvaluator::Four ||
+             (ply >= 2 && stoneThreat(game, plyMoves[ply - 2], Side) != PatternEvaluator::NoThreat))) {
+            quiescenceBudget = quiescenceNodeLimit;
+            return quiescence<Side>(game, ply, currentScore);
+        }
         return currentScore;
+    }
+
+    // Нулевой ход: противник ходит дважды подряд. Если и так оценка не ниже beta, узел отсекается.
+    // Не делается в ответ на угрозу (противник успел бы её реализовать) и дважды на одном пути.
+    if (nullMovePruning && !inNullMove && depth >= NULL_MOVE_MIN_DEPTH && ply > 0 && ply < MAX_SEARCH_DEPTH &&
+        quietMoves[ply - 1] && currentScore >= beta && beta < WIN_SCORE) {
+        quietMoves[ply] = true;
+        plyMoves[ply] = -1;
+        inNullMove = true;
+        int score = -negamax<Opponent>(game, depth - 1 - NULL_MOVE_REDUCTION, ply + 1, -beta, -beta + 1);
+        inNullMove = false;
+        if (stopped)
+            return 0;
+        if (score >= beta) {
+            SEARCH_STAT(stats.nullMoveCutoffs++);
+            return beta;
+        }
+    }
+
+    // Ходы узла – клетки фронтира без запрещённых; список уровня ply живёт в поисковике
+    // (depth > 0, поэтому ply < глубины итерации <= MAX_SEARCH_DEPTH).
+    MoveList &moves = moveLists[ply];
+    moves.count = 0;
+    bool checkForbidden = game.hasForbiddenMoves(Side);
+    for (int i = 0; i < game.candidateCount(); i++) {
+        int cell = game.candidateAt(i);
+        if (!checkForbidden || !game.isForbidden(cell / Game::BOARD_SIZE, cell % Game::BOARD_SIZE, Side))
+            moves.cells[moves.count++] = MoveCell(cell);
+    }
+    if (moves.count == 0)
+        return 0;  // ничья (или у чёрных остались только запрещённые ходы рядом с камнями)
+
+    int quietStart = orderMoves(game, moves, ttMove, depth, ply, Side);
+
+    // Отсечение по оценке: даже с запасом на лучший тихий ход оценка не дотягивает до alpha.
+    bool futile = futilityPruning && depth <= FUTILITY_DEPTH && alpha > -WIN_SCORE && alpha < WIN_SCORE &&
+                  currentScore + FUTILITY_MARGIN[depth] <= alpha;
+
+    int bestEval = -INFINITE_SCORE;
+    int bestCell = moves.cells[0];
+    for (int i = 0; i < moves.count; i++) {
+        int cell = moves.cells[i];
+        std::pair<int, int> move(cell / Game::BOARD_SIZE, cell % Game::BOARD_SIZE);
+        bool late = i >= quietStart;
+        bool quiet = late;
+        // Угрозы на глубине 1 orderMoves не распознаёт, поэтому там ход проверяется отдельно.
+        if (depth == 1 && futile && late)
+            quiet = !isForcingMove(game, move, Side);
+        if (futile && late && quiet && i > 0) {
+            SEARCH_STAT(stats.futilityPrunes++);
+            bestEval = std::max(bestEval, currentScore + FUTILITY_MARGIN[depth]);
+            continue;
+        }
+        int reduction = 0;
+        if (lateMoveReductions && quiet && depth >= LMR_MIN_DEPTH && i >= LMR_FULL_MOVES)
+            reduction = (i >= LMR_DEEP_MOVES && depth > LMR_MIN_DEPTH) ? 2 : 1;
+        quietMoves[ply] = quiet;
+        plyMoves[ply] = cell;
+        int eval = searchMove<Side>(game, move, depth, ply, alpha, beta, i == 0, reduction);
+        if (stopped)
+            return 0;
+        if (eval > bestEval) {
+            bestEval = eval;
+            bestCell = cell;
+        }
+        alpha = std::max(alpha, bestEval);
+        if (alpha >= beta) {
+            recordCutoff(game, move, depth, ply, Side, i);
+            break;  // отсечение
+        }
+    }
+
+    TranspositionTable::Bound bound = TranspositionTable::Exact;
+    if (bestEval <= alphaOrig)
+        bound = TranspositionTable::Upper;
+    else if (bestEval >= betaOrig)
+        bound = TranspositionTable::Lower;
+    tt->store(key, bestEval, depth, bound, toCanonical<N>(bestCell, symmetry));
+    return bestEval;
+}
+
+/**
+ * @brief quiescence Продление угроз на горизонте.
+ *
+ * Это не поиск успокоения с окном, а продление одной форсированной линии: в каждом узле
+ * либо есть единственный ответ (защита от пятёрки), либо оценка окончательна. Перебирать
+ * нечего, поэтому окно alpha-beta не нужно; отсечение по standPat >= beta было бы и неверным,
+ * так как при угрозе пятёрки standPat не отражает позицию.
+ *
+ * Разрешаются только угрозы, при которых статическая оценка заведомо неверна:
+ *   - своя пятёрка – победа;
+ *   - у противника ход в пятёрку – единственная защита (две такие клетки – проигрыш),
+ *     после которой продление продолжается;
+ *   - своя открытая четвёрка – выигрыш по угрозам (THREAT_WIN_SCORE);
+ *   - иначе возвращается оценка без хода (stand pat).
+ * Чужая открытая тройка оставляется оценке: защита от неё даёт обороняющемуся лишний
+ * камень без ответного хода атакующего, и в турнирах такое продление играло слабее.
+ * Свои закрытые четвёрки не перебираются – форсированные серии ищет ThreatSolver в корне.
+ * Когда лимит узлов листа исчерпан, возвращается standPat.
+ */
+template <int N>
+template <GameLogicBase::Player Side>
+int BasicAlphaBetaAI<N>::quiescence(Game &game, int ply, int standPat) {
+    constexpr GameLogicBase::Player Opponent = (Side == Game::AI) ? Game::Human : Game::AI;
+    if (checkStop())
+        return 0;
+    SEARCH_STAT(stats.quiescenceNodes++);
+    SEARCH_STAT(if (ply > stats.maxPly) stats.maxPly = ply);
+    if (--quiescenceBudget < 0)
+        return standPat;
+
+    // Запрещённые ходы (чёрных в рэндзю) не делаются, но угроза противника в такой клетке остаётся.
+    int opponentFives = 0;
+    int block = -1;
+    bool openFour = false;
+    for (int i = 0; i < game.candidateCount(); i++) {
+        int cell = game.candidateAt(i);
+        int row = cell / Game::BOARD_SIZE, col = cell % Game::BOARD_SIZE;
+        PatternEvaluator::Threat own = PatternEvaluator::moveThreat(game, row, col, Side);
+        bool five = PatternEvaluator::moveThreat(game, row, col, Opponent) == PatternEvaluator::Five;
+        opponentFives += five;
+        if ((own < PatternEvaluator::OpenFour && !five) || game.isForbidden(row, col, Side))
+            continue;
+        if (own == PatternEvaluator::Five)
+            return WIN_SCORE;
+        openFour = openFour || own == PatternEvaluator::OpenFour;
+        if (five)
+            block = cell;
+    }
+
+    if (opponentFives == 0)
+        return openFour ? THREAT_WIN_SCORE : standPat;
+    if (opponentFives > 1 || block < 0)
+        return -WIN_SCORE; // обе пятёрки не закрыть (или закрыть можно только запрещённым ходом)
 
-    std::vector<std::pair<int, int>> moves = game.getAvailableMoves();
-    if (moves.empty())
-        return 0;  // ничья
+    int row = block / Game::BOARD_SIZE, col = block % Game::BOARD_SIZE;
+    game.makeMove(row, col, Side);
+    int childScore = (Opponent == Game::AI) ? evaluate(game) : -evaluate(game);
+    int score = -childScore;
+    if (childScore < WIN_SCORE && childScore > -WIN_SCORE)
+        score = -quiescence<Opponent>(game, ply + 1, childScore);
+    game.undoMove(row, col);
+    return stopped ? 0 : score;
+}
 
-    if (maximizingPlayer) {
-        int maxEval = std::numeric_limits<int>::min();
-        for (auto move : moves) {
-            game.makeMove(move.first, move.second, GameLogic::AI);
-            int eval = alphaBeta(game, depth - 1, alpha, beta, false);
+/**
+ * @brief searchMove Делает ход игрока Side, ищет получившуюся позицию и отменяет ход.
+ *
+ * В режиме PVS первый ход узла ищется с полным окном, а остальные – с нулевым окном
+ * (alpha, alpha + 1): достаточно доказать, что ход не лучше уже найденного.
+ * Если нулевое окно показало, что ход лучше, он ищется повторно с полным окном.
+ * Сокращённый ход (LMR) сначала ищется с нулевым окном на depth - 1 - reduction;
+ * если он оказался лучше alpha, дальше он ищется как обычно, без сокращения.
+ *
+ * @param depth Глубина узла, в котором делается ход.
+ * @param ply Расстояние этого узла от корня.
+ * @param firstMove Ход первый в своём узле.
+ * @return Оценка хода с точки зрения Side.
+ */
+template <int N>
+template <GameLogicBase::Player Side>
+int BasicAlphaBetaAI<N>::searchMove(Game &game, std::pair<int, int> move, int depth, int ply, int alpha, int beta,
+                            bool firstMove, int reduction) {
+    constexpr GameLogicBase::Player Opponent = (Side == Game::AI) ? Game::Human : Game::AI;
+    game.makeMove(move.first, move.second, Side);
+    int score;
+    if (reduction > 0) {
+        SEARCH_STAT(stats.reductions++);
+        score = -negamax<Opponent>(game, depth - 1 - reduction, ply + 1, -alpha - 1, -alpha);
+        if (stopped || score <= alpha) {
             game.undoMove(move.first, move.second);
-            maxEval = std::max(maxEval, eval);
-            alpha = std::max(alpha, maxEval);
-            if (beta <= alpha)
-                break;  // отсечение
+            return score;
         }
-        return maxEval;
+        SEARCH_STAT(stats.reductionResearches++);
+    }
+    if (firstMove || searchMode == SearchMode::AlphaBeta) {
+        score = -negamax<Opponent>(game, depth - 1, ply + 1, -beta, -alpha);
     } else {
-        int minEval = std::numeric_limits<int>::max();
-        for (auto move : moves) {
-            game.makeMove(move.first, move.second, GameLogic::Human);
-            int eval = alphaBeta(game, depth - 1, alpha, beta, true);
-            game.undoMove(move.first, move.second);
-            minEval = std::min(minEval, eval);
-            beta = std::min(beta, minEval);
-            if (beta <= alpha)
-                break;  // отсечение
+        score = -negamax<Opponent>(game, depth - 1, ply + 1, -alpha - 1, -alpha);
+        if (!stopped && score > alpha && score < beta) {
+            SEARCH_STAT(stats.researches++);
+            score = -negamax<Opponent>(game, depth - 1, ply + 1, -beta, -alpha);
         }
-        return minEval;
+    }
+    game.undoMove(move.first, move.second);
+    return score;
+}
+
+/**
+ * @brief orderMoves Сортирует ходы узла по убыванию приоритета.
+ *
+ * Приоритет складывается в 64-битный ключ, старшие разряды которого задают группу:
+ * ход из таблицы транспозиций, ход-угроза, ход-убийца, остальные. Внутри группы угроз
+ * ходы упорядочены по силе угрозы (своя угроза важнее блока такой же угрозы противника),
+ * а все группы, кроме первой, дополнительно упорядочены по счётчику истории.
+ *
+ * На глубине 1 угрозы не ищутся: потомки такого узла – листья, и их оценка
+ * дешевле, чем распознавание угроз для каждого хода.
+ *
+ * Ключ сдвигается на ORDER_SHIFT разрядов, а в освободившиеся младшие разряды
+ * записываются номер хода в списке (в обратном порядке) и клетка хода: ключи
+ * становятся различными, и обычная сортировка без буфера в куче сохраняет исходный
+ * порядок равных ходов, как устойчивая.
+ *
+ * Возвращает число ходов первых трёх групп – с него начинаются тихие ходы.
+ */
+template <int N>
+int BasicAlphaBetaAI<N>::orderMoves(const Game &game, MoveList &moves, int ttMove, int depth, int ply,
+                                    GameLogicBase::Player side) {
+    static const long long TT_MOVE_KEY = 4LL << 40;
+    static const long long THREAT_KEY = 3LL << 40;
+    static const long long KILLER_KEY = 2LL << 40;
+    static const int THREAT_SHIFT = 32;
+    static const int CELL_BITS = 9; // Разрядов на номер хода и на клетку (доска до 512 клеток).
+    static const int ORDER_SHIFT = 2 * CELL_BITS;
+    static const int CELL_MASK = (1 << CELL_BITS) - 1;
+    static_assert(Game::CELL_COUNT <= (1 << CELL_BITS), "номер хода и клетка не помещаются в ключ сортировки");
+
+    GameLogicBase::Player self = side;
+    GameLogicBase::Player opponent = (side == Game::AI) ? Game::Human : Game::AI;
+    const int *historyTable = history[side == Game::AI ? 0 : 1];
+    const int *plyKillers = (ply < MAX_SEARCH_DEPTH) ? killers[ply] : nullptr;
+
+    for (int i = 0; i < moves.count; i++) {
+        int cell = moves.cells[i];
+        int row = cell / Game::BOARD_SIZE, col = cell % Game::BOARD_SIZE;
+        long long key = historyTable[cell];
+        if (cell == ttMove) {
+            key += TT_MOVE_KEY;
+        } else if (depth > 1) {
+            int own = PatternEvaluator::moveThreat(game, row, col, self);
+            int block = PatternEvaluator::moveThreat(game, row, col, opponent);
+            int threat = std::max(own * 2, block * 2 - 1);
+            if (threat > 0)
+                key += THREAT_KEY + (static_cast<long long>(threat) << THREAT_SHIFT);
+            else if (plyKillers && (cell == plyKillers[0] || cell == plyKillers[1]))
+                key += KILLER_KEY;
+        } else if (plyKillers && (cell == plyKillers[0] || cell == plyKillers[1])) {
+            key += KILLER_KEY;
+        }
+        orderKeys[i] = (key << ORDER_SHIFT) | (static_cast<long long>(CELL_MASK - i) << CELL_BITS) | cell;
+    }
+    std::sort(orderKeys, orderKeys + moves.count, std::greater<long long>());
+    int quietStart = 0;
+    for (int i = 0; i < moves.count; i++) {
+        moves.cells[i] = MoveCell(orderKeys[i] & CELL_MASK);
+        if (orderKeys[i] >= (KILLER_KEY << ORDER_SHIFT))
+            quietStart = i + 1;
+    }
+    return quietStart;
+}
+
+/**
+ * @brief recordCutoff Обновляет статистику и эвристики после бета-отсечения.
+ *
+ * Угрозы и так проверяются раньше тихих ходов, поэтому ходами-убийцами и в истории
+ * запоминаются только тихие ходы.
+ */
+template <int N>
+void BasicAlphaBetaAI<N>::recordCutoff(const Game &game, std::pair<int, int> move, int depth, int ply,
+                               GameLogicBase::Player side, int moveIndex) {
+    SEARCH_STAT(stats.cutoffsByIndex[moveIndex < SearchStats::CUTOFF_BUCKETS ? moveIndex
+                                                                            : SearchStats::CUTOFF_BUCKETS - 1]++);
+
+    if (isForcingMove(game, move, side))
+        return;
+
+    int cell = move.first * Game::BOARD_SIZE + move.second;
+    if (ply < MAX_SEARCH_DEPTH && killers[ply][0] != cell) {
+        killers[ply][1] = killers[ply][0];
+        killers[ply][0] = cell;
+    }
+    int &counter = history[side == Game::AI ? 0 : 1][cell];
+    counter += depth * depth;
+    // Счётчик ограничен, чтобы не переполнить разряды ключа сортировки.
+    if (counter > (1 << 30))
+        counter = 1 << 30;
+}
+
+template <int N>
+void BasicAlphaBetaAI<N>::resetOrdering() {
+    for (int ply = 0; ply < MAX_SEARCH_DEPTH; ply++)
+        killers[ply][0] = killers[ply][1] = -1;
+    for (int side = 0; side < 2; side++)
+        for (int cell = 0; cell < Game::CELL_COUNT; cell++)
+            history[side][cell] /= 2;
+    stats.clear();
+}
+
+/**
+ * @brief extractPv Проходит по лучшим ходам из таблицы транспозиций, начиная с firstMove.
+ *
+ * Обход останавливается на позиции без записи, на недопустимом ходе (запись могла быть
+ * замещена другой позицией) или на выигранной позиции.
+ */
+template <int N>
+int BasicAlphaBetaAI<N>::extractPv(Game &game, std::pair<int, int> firstMove, bool maximizingPlayer,
+                                   std::pair<int, int> *pv, int maxLength) const {
+    int length = 0;
+    bool maximizing = maximizingPlayer;
+    std::pair<int, int> move = firstMove;
+    while (length < maxLength && game.isMoveValid(move.first, move.second)) {
+        game.makeMove(move.first, move.second, maximizing ? Game::AI : Game::Human);
+        pv[length++] = move;
+        maximizing = !maximizing;
+        if (game.checkWinner() != Game::None)
+            break;
+        TranspositionTable::Entry entry;
+        int symmetry;
+        uint64_t key = game.canonicalHash(maximizing ? Game::AI : Game::Human, symmetry);
+        if (!tt->probe(key, entry) || entry.move < 0)
+            break;
+        int cell = fromCanonical<N>(entry.move, symmetry);
+        move = std::make_pair(cell / Game::BOARD_SIZE, cell % Game::BOARD_SIZE);
+    }
+    for (int i = length - 1; i >= 0; i--)
+        game.undoMove(pv[i].first, pv[i].second);
+    return length;
+}
+
+/**
+ * @brief searchRoot Одна итерация поиска в корне на заданную глубину.
+ *
+ * Ходы перебираются в порядке списка moves: он упорядочен один раз перед итеративным
+ * углублением (orderMoves), а лучший ход прошлой итерации перенесён в его начало.
+ * Если оценка вышла за окно [alpha, beta], перебор прекращается: вызывающий код
+ * повторит поиск с более широким окном.
+ *
+ * @return Оценка лучшего хода с точки зрения Side (не имеет смысла, если поиск был прерван).
+ */
+template <int N>
+template <GameLogicBase::Player Side>
+int BasicAlphaBetaAI<N>::searchRoot(Game &game, int depth, int alpha, int beta,
+                            const MoveList &moves, std::pair<int, int> &bestMove) {
+    int bestScore = -INFINITE_SCORE;
+    bestMove = std::make_pair(moves.cells[0] / Game::BOARD_SIZE, moves.cells[0] % Game::BOARD_SIZE);
+    for (int i = 0; i < moves.count; i++) {
+        auto move = std::make_pair(moves.cells[i] / Game::BOARD_SIZE, moves.cells[i] % Game::BOARD_SIZE);
+        if (nullMovePruning)
+            quietMoves[0] = !isForcingMove(game, move, Side);
+        plyMoves[0] = moves.cells[i];
+        int score = searchMove<Side>(game, move, depth, 0, alpha, beta, i == 0);
+        if (stopped)
+            break;
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = move;
+        }
+        alpha = std::max(alpha, bestScore);
+        if (alpha >= beta)
+            break;  // оценка вышла за окно стремления
+    }
+    return bestScore;
+}
+
+template <int N>
+int BasicAlphaBetaAI<N>::searchRoot(Game &game, int depth, int alpha, int beta, bool maximizingPlayer,
+                            const MoveList &moves, std::pair<int, int> &bestMove) {
+    return maximizingPlayer ? searchRoot<Game::AI>(game, depth, alpha, beta, moves, bestMove)
+                            : searchRoot<Game::Human>(game, depth, alpha, beta, moves, bestMove);
+}
+
+/**
+ * @brief searchRootAspiration Итерация корня с окном стремления вокруг previousScore.
+ *
+ * Оценка в гомоку заметно колеблется между чётными и нечётными глубинами (на нечётной
+ * последний ход за ищущим игроком), поэтому вызывающий код передаёт оценку итерации
+ * той же чётности – на две глубины меньше. Окно [previousScore - delta, previousScore + delta];
+ * при выходе оценки за окно соответствующая граница отодвигается, а delta растёт вчетверо.
+ * Когда окно становится шире оценки выигрыша, поиск повторяется с полным окном.
+ */
+template <int N>
+int BasicAlphaBetaAI<N>::searchRootAspiration(Game &game, int depth, bool maximizingPlayer, int previousScore,
+                                      const MoveList &moves, std::pair<int, int> &bestMove) {
+    int delta = ASPIRATION_WINDOW;
+    int alpha = previousScore - delta;
+    int beta = previousScore + delta;
+    while (true) {
+        int score = searchRoot(game, depth, alpha, beta, maximizingPlayer, moves, bestMove);
+        if (stopped || (score > alpha && score < beta))
+            return score;
+        SEARCH_STAT(stats.researches++);
+        delta *= 4;
+        if (score <= alpha)
+            alpha = (delta >= WIN_SCORE) ? -INFINITE_SCORE : previousScore - delta;
+        else
+            beta = (delta >= WIN_SCORE) ? INFINITE_SCORE : previousScore + delta;
+        if (alpha == -INFINITE_SCORE && beta == INFINITE_SCORE)
+            return searchRoot(game, depth, alpha, beta, maximizingPlayer, moves, bestMove);
     }
 }
 
 /**
  * @brief getBestMove Определяет лучший ход для ИИ (по умолчанию для максимизирующего игрока).
  */
-std::pair<int, int> AlphaBetaAI::getBestMove(GameLogic &game, int depth) {
+template <int N>
+std::pair<int, int> BasicAlphaBetaAI<N>::getBestMove(Game &game, int depth) {
     return getBestMove(game, depth, true);
 }
 
@@ -155,91 +765,311 @@ std::pair<int, int> AlphaBetaAI::getBestMove(GameLogic &game, int depth) {
  * @brief getBestMove Перегруженный метод, определяющий лучший ход для выбранного игрока.
  *
  * Если maximizingPlayer == true, считается, что оптимальный ход выбирается для максимизирующего игрока (например, AI).
- * Если false – для минимизирующего (например, Human). Перед выполнением основного поиска
- * проверяются возможность мгновенной победы и возможность блокировки.
+ * Если false – для минимизирующего (например, Human).
  *
  * @param game Текущее состояние игры.
  * @param depth Глубина поиска.
  * @param maximizingPlayer Если true, оптимизируем для максимизирующего игрока, иначе для минимизирующего.
  * @return Пара координат (row, col) лучшего хода.
  */
-std::pair<int, int> AlphaBetaAI::getBestMove(GameLogic &game, int depth, bool maximizingPlayer) {
-    std::vector<std::pair<int, int>> moves = game.getAvailableMoves();
-    if (moves.empty())
-        return std::make_pair(-1, -1);
-
-    if (maximizingPlayer) {
-        // 1. Проверка: может ли AI выиграть за один ход.
-        for (auto move : moves) {
-            game.makeMove(move.first, move.second, GameLogic::AI);
-            if (game.checkWin(move.first, move.second, GameLogic::AI)) {
-                game.undoMove(move.first, move.second);
-                return move;
-            }
-            game.undoMove(move.first, move.second);
+template <int N>
+std::pair<int, int> BasicAlphaBetaAI<N>::getBestMove(Game &game, int depth, bool maximizingPlayer) {
+    SearchLimits limits;
+    limits.maxDepth = depth;
+    return search(game, limits, maximizingPlayer).move;
+}
+
+/**
+ * @brief getBestMoveTimed Лучший ход, найденный за отведённое время.
+ */
+template <int N>
+std::pair<int, int> BasicAlphaBetaAI<N>::getBestMoveTimed(Game &game, int budgetMs, bool maximizingPlayer) {
+    SearchLimits limits;
+    limits.maxDepth = MAX_SEARCH_DEPTH;
+    limits.timeLimitMs = budgetMs;
+    return search(game, limits, maximizingPlayer).move;
+}
+
+/**
+ * @brief search Поиск с итеративным углублением.
+ *
+ * Сначала проверяются возможность мгновенной победы и необходимость блокировки,
+ * затем ход ищется в дебютной книге, затем ищется форсированный выигрыш
+ * по угрозам (VCF, потом VCT; обоим вместе отводится до восьмой части лимита времени).
+ * Затем выполняются итерации на глубину 1, 2, ..., limits.maxDepth.
+ * Каждая итерация начинается с лучшего хода предыдущей, а внутри дерева главный
+ * вариант прошлой итерации подсказывается ходами из таблицы транспозиций.
+ * Если время истекло посреди итерации, она отбрасывается и возвращается результат
+ * последней завершённой итерации. Новая итерация не начинается, если уже израсходована
+ * половина времени, оставшегося к началу углубления: она почти наверняка не успеет завершиться.
+ */
+template <int N>
+SearchResult BasicAlphaBetaAI<N>::search(Game &game, const SearchLimits &limits, bool maximizingPlayer) {
+    startTime = std::chrono::steady_clock::now();
+    timeLimitMs = limits.timeLimitMs;
+    searchMode = limits.mode;
+    lateMoveReductions = limits.lateMoveReductions;
+    futilityPruning = limits.futilityPruning;
+    nullMovePruning = limits.nullMovePruning;
+    quiescenceNodeLimit = limits.quiescenceNodeLimit;
+    // Списки ходов и ходы-убийцы есть только на MAX_SEARCH_DEPTH уровней дерева.
+    int maxDepth = std::min(limits.maxDepth, int(MAX_SEARCH_DEPTH));
+    nodes = 0;
+    publishedNodes.store(0, std::memory_order_relaxed);
+    completedDepth = 0;
+    stopped = stopRequested.load(std::memory_order_relaxed);
+    tt->newSearch();
+    resetOrdering();
+
+    SearchResult result;
+    GameLogicBase::Player self = maximizingPlayer ? Game::AI : Game::Human;
+    GameLogicBase::Player opponent = maximizingPlayer ? Game::Human : Game::AI;
+    int winScore = maximizingPlayer ? WIN_SCORE : -WIN_SCORE;
+
+    // Ходы корня – клетки фронтира без запрещённых (на пустой доске – центр); список корня
+    // занимает нулевой уровень moveLists, которым дерево не пользуется.
+    MoveList &moves = moveLists[0];
+    moves.count = 0;
+    if (game.stoneCount() == 0) {
+        moves.cells[moves.count++] = MoveCell(Game::BOARD_SIZE / 2 * Game::BOARD_SIZE + Game::BOARD_SIZE / 2);
+    } else {
+        bool checkForbidden = game.hasForbiddenMoves(self);
+        for (int i = 0; i < game.candidateCount(); i++) {
+            int cell = game.candidateAt(i);
+            if (!checkForbidden || !game.isForbidden(cell / Game::BOARD_SIZE, cell % Game::BOARD_SIZE, self))
+                moves.cells[moves.count++] = MoveCell(cell);
         }
-        
-        // 2. Проверка: может ли Human выиграть за один ход – блокируем.
-        for (auto move : moves) {
-            game.makeMove(move.first, move.second, GameLogic::Human);
-            if (game.checkWin(move.first, move.second, GameLogic::Human)) {
-                game.undoMove(move.first, move.second);
-                return move;
-            }
-            game.undoMove(move.first, move.second);
+    }
+    if (moves.count == 0)
+        return result;
+
+    // Единственный кандидат (например, центр пустой доски) не требует поиска.
+    if (moves.count == 1) {
+        result.move = std::make_pair(moves.cells[0] / Game::BOARD_SIZE, moves.cells[0] % Game::BOARD_SIZE);
+        result.score = evaluate(game);
+        result.stats.setPv(&result.move, 1);
+        return result;
+    }
+
+    // 1. Проверка: может ли текущий игрок выиграть за один ход.
+    for (int i = 0; i < moves.count; i++) {
+        auto move = std::make_pair(moves.cells[i] / Game::BOARD_SIZE, moves.cells[i] % Game::BOARD_SIZE);
+        if (game.checkWin(move.first, move.second, self)) {
+            result.move = move;
+            result.score = winScore;
+            result.depth = 1;
+            result.stats.setPv(&move, 1);
+            return result;
         }
-        
-        // 3. Если прямых вариантов нет, выполняем стандартный поиск для максимизирующего игрока.
-        int bestScore = std::numeric_limits<int>::min();
-        std::pair<int, int> bestMove = moves[0];
-        int alpha = std::numeric_limits<int>::min();
-        int beta = std::numeric_limits<int>::max();
-        for (auto move : moves) {
-            game.makeMove(move.first, move.second, GameLogic::AI);
-            int score = alphaBeta(game, depth - 1, alpha, beta, false);
-            game.undoMove(move.first, move.second);
-            if (score > bestScore) {
-                bestScore = score;
-                bestMove = move;
-            }
-            alpha = std::max(alpha, bestScore);
+    }
+
+    // 2. Проверка: может ли противник выиграть за один ход – блокируем.
+    for (int i = 0; i < moves.count; i++) {
+        auto move = std::make_pair(moves.cells[i] / Game::BOARD_SIZE, moves.cells[i] % Game::BOARD_SIZE);
+        if (game.checkWin(move.first, move.second, opponent)) {
+            result.move = move;
+            result.score = evaluate(game);
+            result.depth = 1;
+            result.stats.setPv(&move, 1);
+            return result;
         }
-        return bestMove;
-    } else {
-        // Для минимизирующего игрока (Human):
-        // 1. Проверяем возможность мгновенной победы для Human.
-        for (auto move : moves) {
-            game.makeMove(move.first, move.second, GameLogic::Human);
-            if (game.checkWin(move.first, move.second, GameLogic::Human)) {
-                game.undoMove(move.first, move.second);
-                return move;
+    }
+
+    // 3. Ход из дебютной книги (книга строится по правилам свободного стиля); проверки 1–2
+    // идут раньше, чтобы книга не заменила выигрыш или вынужденную защиту.
+    if (limits.useBook && openingBook && game.getRules() == GameLogicBase::Freestyle &&
+        openingBook->probe(game, self, result.move)) {
+        result.score = evaluate(game);
+        result.fromBook = true;
+        result.timeMs = elapsedMs();
+        result.stats.setPv(&result.move, 1);
+        return result;
+    }
+
+    // 4. Поиск форсированного выигрыша по угрозам: сначала VCF, затем VCT.
+    // Оба поиска делят одну долю лимита времени: VCT получает то, что осталось после VCF.
+    if (limits.threatNodeLimit > 0) {
+        ThreatLimits threatLimits;
+        threatLimits.maxNodes = limits.threatNodeLimit;
+        long long threatDeadline = elapsedMs() + limits.timeLimitMs / THREAT_TIME_DIVISOR;
+        ThreatSolver::Mode modes[2] = {ThreatSolver::VCF, ThreatSolver::VCT};
+        for (ThreatSolver::Mode mode : modes) {
+            if (limits.timeLimitMs > 0) {
+                long long left = threatDeadline - elapsedMs();
+                if (left <= 0)
+                    break;
+                threatLimits.timeLimitMs = int(left);
             }
-            game.undoMove(move.first, move.second);
-        }
-        // 2. Проверяем, может ли AI выиграть за один ход – блокируем.
-        for (auto move : moves) {
-            game.makeMove(move.first, move.second, GameLogic::AI);
-            if (game.checkWin(move.first, move.second, GameLogic::AI)) {
-                game.undoMove(move.first, move.second);
-                return move;
+            ThreatResult threat = threatSolver.solve(game, self, mode, threatLimits);
+            nodes += threat.nodes;
+            if (threat.found) {
+                const std::vector<std::pair<int, int>> &line = threatSolver.line();
+                result.move = line[0];
+                result.score = winScore;
+                result.depth = int(line.size());
+                result.forcedLength = int(line.size());
+                result.nodes = nodes;
+                result.timeMs = elapsedMs();
+                result.stats.nodes = nodes;
+                result.stats.addIteration(result.timeMs);
+                result.stats.setPv(line.data(), int(line.size()));
+                return result;
             }
-            game.undoMove(move.first, move.second);
-        }
-        // 3. Стандартный поиск для минимизирующего игрока.
-        int bestScore = std::numeric_limits<int>::max();
-        std::pair<int, int> bestMove = moves[0];
-        int alpha = std::numeric_limits<int>::min();
-        int beta = std::numeric_limits<int>::max();
-        for (auto move : moves) {
-            game.makeMove(move.first, move.second, GameLogic::Human);
-            int score = alphaBeta(game, depth - 1, alpha, beta, true);
-            game.undoMove(move.first, move.second);
-            if (score < bestScore) {
-                bestScore = score;
-                bestMove = move;
+            if (stopRequested.load(std::memory_order_relaxed)) {
+                stopped = true;
+                break;
             }
-            beta = std::min(beta, bestScore);
         }
-        return bestMove;
     }
+
+    // 5. Итеративное углубление; в параллельном режиме вместе с ним запускаются вспомогательные потоки.
+    // Ходы корня упорядочиваются один раз, дальше в начало переносится лучший ход итерации.
+    // В симметричной позиции из равноценных ходов остаётся по одному.
+    removeSymmetricMoves(game, moves);
+    TranspositionTable::Entry rootEntry;
+    int rootSymmetry;
+    uint64_t rootKey = game.canonicalHash(self, rootSymmetry);
+    int rootTtMove = tt->probe(rootKey, rootEntry) ? fromCanonical<N>(rootEntry.move, rootSymmetry) : -1;
+    orderMoves(game, moves, rootTtMove, maxDepth, 0, self);
+
+    // Вспомогательные потоки уже запущены (setThreadCount) и ждут задания: позицию и ходы корня
+    // они получают копированием в свою память.
+    for (std::size_t i = 0; i < helpers.size(); i++) {
+        BasicAlphaBetaAI *helper = helpers[i].get();
+        helper->clearStopRequest();
+        helper->searchMode = searchMode;
+        helper->lateMoveReductions = lateMoveReductions;
+        helper->futilityPruning = futilityPruning;
+        helper->nullMovePruning = nullMovePruning;
+        helper->quiescenceNodeLimit = quiescenceNodeLimit;
+        {
+            std::lock_guard<std::mutex> lock(helper->workerMutex);
+            helper->workerGame = game;
+            helper->workerMaxDepth = maxDepth;
+            helper->workerMaximizing = maximizingPlayer;
+            helper->workerIndex = int(i) + 1;
+            helper->moveLists[0].count = moves.count;
+            std::copy(moves.cells, moves.cells + moves.count, helper->moveLists[0].cells);
+            helper->workerBusy = true;
+        }
+        helper->workerSignal.notify_all();
+    }
+
+    result.move = std::make_pair(moves.cells[0] / Game::BOARD_SIZE, moves.cells[0] % Game::BOARD_SIZE);
+    // Остаток лимита на углубление считается от его начала, без времени проверок и поиска по угрозам.
+    long long deepeningStartMs = elapsedMs();
+    int iterationScores[MAX_SEARCH_DEPTH]; // Оценки завершённых итераций (индекс – глубина - 1).
+    for (int depth = 1; depth <= maxDepth; depth++) {
+        std::pair<int, int> iterationMove;
+        int score;
+        // Окно стремления строится вокруг оценки итерации той же чётности (см. searchRootAspiration).
+        if (searchMode == SearchMode::Pvs && depth > 2)
+            score = searchRootAspiration(game, depth, maximizingPlayer, iterationScores[depth - 3], moves,
+                                         iterationMove);
+        else
+            score = searchRoot(game, depth, -INFINITE_SCORE, INFINITE_SCORE, maximizingPlayer, moves, iterationMove);
+        if (stopped)
+            break;
+        result.move = iterationMove;
+        result.score = maximizingPlayer ? score : -score; // в SearchResult оценка – с точки зрения AI
+        result.depth = depth;
+        completedDepth = depth;
+        iterationScores[depth - 1] = score;
+        stats.addIteration(elapsedMs());
+        stats.pvLength = extractPv(game, iterationMove, maximizingPlayer, stats.pv,
+                                   std::min(depth, int(SearchStats::MAX_PV_LENGTH)));
+
+        // Лучший ход итерации переносится в начало списка, сохраняя порядок остальных.
+        MoveCell *it = std::find(moves.cells, moves.cells + moves.count,
+                                 MoveCell(iterationMove.first * Game::BOARD_SIZE + iterationMove.second));
+        std::rotate(moves.cells, it, it + 1);
+
+        if (progressCallback) {
+            result.nodes = nodes;
+            for (const auto &helper : helpers)
+                result.nodes += helper->publishedNodes.load(std::memory_order_relaxed);
+            result.timeMs = elapsedMs();
+            // Счётчики вспомогательных потоков меняются прямо сейчас, поэтому до их остановки
+            // в промежуточную статистику попадают только счётчики основного потока.
+            result.stats = stats;
+            result.stats.nodes = result.nodes;
+            progressCallback(result);
+        }
+
+        if (score >= WIN_SCORE || score <= -WIN_SCORE)
+            break;
+        if (timeLimitMs > 0 && (elapsedMs() - deepeningStartMs) * 2 >= timeLimitMs - deepeningStartMs)
+            break;
+    }
+
+    result.nodes = nodes;
+    stats.nodes = nodes;
+    result.stats = stats;
+    for (std::size_t i = 0; i < helpers.size(); i++) {
+        helpers[i]->requestStop();
+        {
+            std::unique_lock<std::mutex> lock(helpers[i]->workerMutex);
+            helpers[i]->workerSignal.wait(lock, [&]() { return !helpers[i]->workerBusy; });
+        }
+        result.nodes += helpers[i]->nodes;
+        helpers[i]->stats.nodes = helpers[i]->nodes;
+        result.stats.merge(helpers[i]->stats);
+    }
+    result.timeMs = elapsedMs();
+    return result;
 }
+
+/**
+ * @brief helperSearch Итеративное углубление вспомогательного потока Lazy SMP.
+ *
+ * Результат потока не используется напрямую: найденные оценки и лучшие ходы попадают
+ * в общую таблицу транспозиций и ускоряют поиск основного потока.
+ */
+template <int N>
+void BasicAlphaBetaAI<N>::helperSearch(Game &game, int maxDepth, bool maximizingPlayer, int threadIndex) {
+    startTime = std::chrono::steady_clock::now();
+    timeLimitMs = 0;
+    nodes = 0;
+    publishedNodes.store(0, std::memory_order_relaxed);
+    completedDepth = 0;
+    stopped = stopRequested.load(std::memory_order_relaxed);
+    resetOrdering();
+
+    MoveList &moves = moveLists[0];
+    std::rotate(moves.cells, moves.cells + threadIndex % moves.count, moves.cells + moves.count);
+    for (int depth = 1 + (threadIndex & 1); depth <= maxDepth && !stopped; depth++) {
+        std::pair<int, int> iterationMove;
+        searchRoot(game, depth, -INFINITE_SCORE, INFINITE_SCORE, maximizingPlayer, moves, iterationMove);
+        if (stopped)
+            break;
+        completedDepth = depth;
+        MoveCell *it = std::find(moves.cells, moves.cells + moves.count,
+                                 MoveCell(iterationMove.first * Game::BOARD_SIZE + iterationMove.second));
+        std::rotate(moves.cells, it, it + 1);
+    }
+}
+
+/**
+ * @brief workerLoop Цикл потока вспомогательного поисковика.
+ *
+ * Поток спит до выдачи задания, выполняет его и сообщает о завершении, сбрасывая workerBusy;
+ * основной поток ждёт этого после requestStop(), прежде чем читать счётчики помощника.
+ */
+template <int N>
+void BasicAlphaBetaAI<N>::workerLoop() {
+    std::unique_lock<std::mutex> lock(workerMutex);
+    while (true) {
+        workerSignal.wait(lock, [this]() { return workerBusy || workerExit; });
+        if (workerExit)
+            return;
+        lock.unlock();
+        helperSearch(workerGame, workerMaxDepth, workerMaximizing, workerIndex);
+        lock.lock();
+        workerBusy = false;
+        workerSignal.notify_all();
+    }
+}
+
+template class BasicAlphaBetaAI<15>;
+template class BasicAlphaBetaAI<19>;
+template class BasicAlphaBetaAI<20>;
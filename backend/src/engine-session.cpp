@@ -0,0 +1,92 @@
+#include "../include/engine-session.h"
+
+namespace {
+
+// Сеанс для доски N x N: все вызовы передаются позиции и поисковику этого размера.
+template <int N>
+class BoardSession : public EngineSession {
+public:
+    int boardSize() const override { return N; }
+
+    void reset() override { game.reset(); }
+    int cell(int row, int col) const override { return game.board[row][col]; }
+    bool isMoveValid(int row, int col) const override { return game.isMoveValid(row, col); }
+
+    bool makeMove(int row, int col, GameLogicBase::Player player) override {
+        return game.makeMove(row, col, player);
+    }
+    void undoMove(int row, int col) override { game.undoMove(row, col); }
+
+    bool playMove(int row, int col, GameLogicBase::Player player) override {
+        return game.playMove(row, col, player);
+    }
+    bool takeBack() override { return game.takeBack(); }
+    bool redoMove() override { return game.redoMove(); }
+    bool canRedo() const override { return game.canRedo(); }
+    const GameLogicBase::RecordedMove &nextRedoMove() const override { return game.nextRedoMove(); }
+    const std::vector<GameLogicBase::RecordedMove> &moveLog() const override { return game.moveLog(); }
+
+    int checkWinner() const override { return game.checkWinner(); }
+    bool isBoardFull() const override { return game.isBoardFull(); }
+
+    // Смена игрока чёрными таблицу не портит: в рэндзю цвет того, кто ходит, входит в ключ.
+    void setRules(GameLogicBase::Rules rules, GameLogicBase::Player black) override {
+        if (rules == game.getRules() && black == game.getBlackPlayer())
+            return;
+        bool clear = rules != game.getRules();
+        game.setRules(rules, black);
+        if (clear)
+            ai.clearHash();
+    }
+    GameLogicBase::Rules rules() const override { return game.getRules(); }
+    GameLogicBase::Player blackPlayer() const override { return game.getBlackPlayer(); }
+    bool isForbidden(int row, int col, GameLogicBase::Player player) const override {
+        return game.isForbidden(row, col, player);
+    }
+
+    SearchResult search(const SearchLimits &limits, bool maximizingPlayer) override {
+        return ai.search(game, limits, maximizingPlayer);
+    }
+
+    SearchResult searchFrom(const std::vector<GameLogicBase::RecordedMove> &moves, const SearchLimits &limits,
+                            bool maximizingPlayer) override {
+        game.reset();
+        for (const GameLogicBase::RecordedMove &move : moves)
+            game.playMove(move.row, move.col, static_cast<GameLogicBase::Player>(move.player));
+        return ai.search(game, limits, maximizingPlayer);
+    }
+
+    Swap2Decision swap2(const std::vector<std::pair<int, int>> &stones, const SearchLimits &limits) override {
+        return Swap2Opening::decide(game, ai, stones, limits);
+    }
+
+    void requestStop() override { ai.requestStop(); }
+    void clearStopRequest() override { ai.clearStopRequest(); }
+    void setProgressCallback(std::function<void(const SearchResult &)> callback) override {
+        ai.setProgressCallback(std::move(callback));
+    }
+    void setThreadCount(int threads) override { ai.setThreadCount(threads); }
+    void setHashSize(std::size_t sizeMb) override { ai.setHashSize(sizeMb); }
+    void clearHash() override { ai.clearHash(); }
+    void setOpeningBook(std::shared_ptr<const OpeningBook> book) override { ai.setOpeningBook(std::move(book)); }
+
+private:
+    BasicGameLogic<N> game;
+    BasicAlphaBetaAI<N> ai;
+};
+
+} // namespace
+
+std::unique_ptr<EngineSession> EngineSession::create(int boardSize) {
+    switch (boardSize) {
+    case 15: return std::unique_ptr<EngineSession>(new BoardSession<15>());
+    case 19: return std::unique_ptr<EngineSession>(new BoardSession<19>());
+    case 20: return std::unique_ptr<EngineSession>(new BoardSession<20>());
+    default: return nullptr;
+    }
+}
+
+const std::vector<int> &EngineSession::supportedBoardSizes() {
+    static const std::vector<int> sizes = {15, 19, 20};
+    return sizes;
+}
@@ -1,81 +1,434 @@
 #include "../include/game-logic.h"
+#include "../include/pattern-evaluator.h"
+#include "../include/renju-rules.h"
+#include <algorithm>
+
+namespace {
+
+// Таблица случайных чисел для Zobrist-хеширования.
+// Числа генерируются детерминированно (splitmix64), чтобы хеши совпадали между запусками.
+// Для каждой симметрии s хранится также ключ образа клетки: symmetric[s][p][i] = ключ клетки transformCell(s, i).
+// У каждого размера доски своя таблица; для 15x15 она совпадает с прежней, поэтому книги остаются верными.
+template <int N>
+struct ZobristKeys {
+    using Game = BasicGameLogic<N>;
+
+    uint64_t cell[2][N][N];
+    uint64_t side;
+    uint64_t blackToMove; // Добавляется к каноническому ключу рэндзю, если ходят чёрные.
+    uint64_t symmetric[Game::SYMMETRY_COUNT][2][Game::CELL_COUNT];
+
+    ZobristKeys() {
+        uint64_t state = 0x9E3779B97F4A7C15ull;
+        for (int p = 0; p < 2; p++)
+            for (int i = 0; i < N; i++)
+                for (int j = 0; j < N; j++)
+                    cell[p][i][j] = next(state);
+        side = next(state);
+        for (int s = 0; s < Game::SYMMETRY_COUNT; s++) {
+            for (int i = 0; i < Game::CELL_COUNT; i++) {
+                int image = Game::transformCell(s, i);
+                for (int p = 0; p < 2; p++)
+                    symmetric[s][p][i] = cell[p][image / N][image % N];
+            }
+        }
+        blackToMove = next(state);
+    }
+
+    static uint64_t next(uint64_t &state) {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+};
+
+template <int N>
+const ZobristKeys<N> &zobristKeys() {
+    static const ZobristKeys<N> keys;
+    return keys;
+}
+
+} // namespace
 
 // Конструктор: заполняет игровое поле значениями None.
-GameLogic::GameLogic() {
+// Журнал сразу рассчитан на партию до заполнения доски, чтобы ходы не вызывали перевыделений.
+template <int N>
+BasicGameLogic<N>::BasicGameLogic()
+    : rules(Freestyle), black(Human), exactFive{false, false}, candidateRadius(DEFAULT_CANDIDATE_RADIUS) {
+    log.reserve(CELL_COUNT);
+    reset();
+}
+
+// Очищает игровое поле, битовые маски линий, счётчики пятёрок и журнал партии; правила сохраняются.
+template <int N>
+void BasicGameLogic<N>::reset() {
     for (int i = 0; i < BOARD_SIZE; i++) {
         for (int j = 0; j < BOARD_SIZE; j++) {
             board[i][j] = None;
         }
     }
+    for (int p = 0; p < 2; p++) {
+        for (int d = 0; d < 4; d++) {
+            for (int k = 0; k < LINE_COUNT; k++) {
+                lines[p][d][k] = 0;
+                lineScores[d][k] = 0;
+            }
+        }
+        fiveLines[p] = 0;
+    }
+    for (int c = 0; c < 2; c++)
+        for (int s = 0; s < SYMMETRY_COUNT; s++)
+            symmetricHashes[c][s] = 0;
+    // На пустой доске ни один ход чёрных не создаёт формы.
+    for (int d = 0; d < 4; d++)
+        for (int i = 0; i < CELL_COUNT; i++)
+            shapes[d][i] = 0;
+    evaluationScore = 0;
+    stones = 0;
+    log.clear();
+    redoLog.clear();
+    rebuildFrontier();
 }
 
 // Проверяет, что координаты (row, col) находятся в пределах поля и клетка пуста.
-bool GameLogic::isMoveValid(int row, int col) const {
+template <int N>
+bool BasicGameLogic<N>::isMoveValid(int row, int col) const {
     if (row < 0 || row >= BOARD_SIZE || col < 0 || col >= BOARD_SIZE)
         return false;
     return board[row][col] == None;
 }
 
 // Делает ход: если клетка пустая, ставит номер игрока и возвращает true.
-bool GameLogic::makeMove(int row, int col, Player player) {
-    if (!isMoveValid(row, col))
+template <int N>
+bool BasicGameLogic<N>::makeMove(int row, int col, Player player) {
+    if (!isMoveValid(row, col) || player == None)
         return false;
     board[row][col] = player;
+    toggleStone(row, col, player);
+    stones++;
+    removeCandidate(row * BOARD_SIZE + col);
+    updateNeighbours(row, col, +1);
+    return true;
+}
+
+// Ход партии: выполняется и записывается в журнал, отменённые ходы забываются.
+template <int N>
+bool BasicGameLogic<N>::playMove(int row, int col, Player player) {
+    if (!makeMove(row, col, player))
+        return false;
+    log.push_back(RecordedMove{uint8_t(row), uint8_t(col), uint8_t(player)});
+    redoLog.clear();
+    return true;
+}
+
+template <int N>
+bool BasicGameLogic<N>::takeBack() {
+    if (log.empty())
+        return false;
+    RecordedMove move = log.back();
+    log.pop_back();
+    undoMove(move.row, move.col);
+    redoLog.push_back(move);
+    return true;
+}
+
+template <int N>
+bool BasicGameLogic<N>::redoMove() {
+    if (redoLog.empty())
+        return false;
+    RecordedMove move = redoLog.back();
+    if (!makeMove(move.row, move.col, static_cast<Player>(move.player)))
+        return false;
+    redoLog.pop_back();
+    log.push_back(move);
     return true;
 }
 
+template <int N>
+BasicGameLogic<N> BasicGameLogic<N>::positionAt(int ply) const {
+    BasicGameLogic position;
+    position.setCandidateRadius(candidateRadius);
+    position.setRules(rules, black);
+    for (int i = 0; i < ply && i < int(log.size()); i++)
+        position.playMove(log[i].row, log[i].col, static_cast<Player>(log[i].player));
+    return position;
+}
+
 // Отменяет ход, устанавливая клетку на None.
-void GameLogic::undoMove(int row, int col) {
-    if (row >= 0 && row < BOARD_SIZE && col >= 0 && col < BOARD_SIZE)
-        board[row][col] = None;
+template <int N>
+void BasicGameLogic<N>::undoMove(int row, int col) {
+    if (row < 0 || row >= BOARD_SIZE || col < 0 || col >= BOARD_SIZE)
+        return;
+    int player = board[row][col];
+    if (player == None)
+        return;
+    toggleStone(row, col, static_cast<Player>(player));
+    board[row][col] = None;
+    stones--;
+    updateNeighbours(row, col, -1);
+    if (neighbours[row][col] > 0)
+        addCandidate(row * BOARD_SIZE + col);
 }
 
-// Проверяет, выиграл ли игрок, сделав ход в точке (row, col).
-// Для этого проверяются 4 направления: горизонталь, вертикаль и две диагонали.
-bool GameLogic::checkWin(int row, int col, Player player) const {
-    int directions[4][2] = { {0, 1}, {1, 0}, {1, 1}, {1, -1} };
+// Обновляет счётчики соседства в квадрате радиуса candidateRadius вокруг клетки.
+// Пустая клетка входит во фронтир, пока её счётчик больше нуля.
+template <int N>
+void BasicGameLogic<N>::updateNeighbours(int row, int col, int delta) {
+    int r0 = std::max(0, row - candidateRadius), r1 = std::min(BOARD_SIZE - 1, row + candidateRadius);
+    int c0 = std::max(0, col - candidateRadius), c1 = std::min(BOARD_SIZE - 1, col + candidateRadius);
+    for (int r = r0; r <= r1; r++) {
+        for (int c = c0; c <= c1; c++) {
+            if (r == row && c == col)
+                continue;
+            neighbours[r][c] += delta;
+            if (board[r][c] != None)
+                continue;
+            if (delta > 0 && neighbours[r][c] == 1)
+                addCandidate(r * BOARD_SIZE + c);
+            else if (delta < 0 && neighbours[r][c] == 0)
+                removeCandidate(r * BOARD_SIZE + c);
+        }
+    }
+}
+
+template <int N>
+void BasicGameLogic<N>::addCandidate(int cell) {
+    if (frontierIndex[cell] >= 0)
+        return;
+    frontierIndex[cell] = frontierSize;
+    frontier[frontierSize++] = cell;
+}
+
+// Удаление: на место удаляемой клетки переносится последняя клетка фронтира.
+template <int N>
+void BasicGameLogic<N>::removeCandidate(int cell) {
+    int index = frontierIndex[cell];
+    if (index < 0)
+        return;
+    int last = frontier[--frontierSize];
+    frontier[index] = last;
+    frontierIndex[last] = index;
+    frontierIndex[cell] = -1;
+}
+
+template <int N>
+void BasicGameLogic<N>::rebuildFrontier() {
+    frontierSize = 0;
+    for (int i = 0; i < CELL_COUNT; i++)
+        frontierIndex[i] = -1;
+    for (int i = 0; i < BOARD_SIZE; i++)
+        for (int j = 0; j < BOARD_SIZE; j++)
+            neighbours[i][j] = 0;
+    for (int i = 0; i < BOARD_SIZE; i++) {
+        for (int j = 0; j < BOARD_SIZE; j++) {
+            if (board[i][j] != None)
+                updateNeighbours(i, j, +1);
+        }
+    }
+}
+
+template <int N>
+void BasicGameLogic<N>::setRules(Rules newRules, Player blackPlayer) {
+    rules = newRules;
+    black = blackPlayer;
+    for (int p = 0; p < 2; p++)
+        exactFive[p] = rules == Standard || (rules == Renju && p == black - 1);
+    rebuildLineCaches();
+}
+
+// Полный пересчёт нужен только при смене правил: от них зависят пятёрки и оценки линий.
+template <int N>
+void BasicGameLogic<N>::rebuildLineCaches() {
+    evaluationScore = 0;
+    fiveLines[0] = fiveLines[1] = 0;
+    for (int d = 0; d < 4; d++) {
+        int count = (d == Horizontal || d == Vertical) ? BOARD_SIZE : LINE_COUNT;
+        for (int k = 0; k < count; k++) {
+            for (int p = 0; p < 2; p++)
+                fiveLines[p] += winningFives(lines[p][d][k], p) != 0;
+            lineScores[d][k] = PatternEvaluator::evaluateLine(*this, d, k);
+            evaluationScore += lineScores[d][k];
+        }
+    }
+    for (int d = 0; d < 4; d++) {
+        for (int i = 0; i < CELL_COUNT; i++) {
+            shapes[d][i] = 0;
+            int row = i / BOARD_SIZE, col = i % BOARD_SIZE;
+            if (rules == Renju && board[row][col] == None) {
+                int index = lineIndex(d, row, col);
+                shapes[d][i] = RenjuRules::lineShape(lines[black - 1][d][index], lines[2 - black][d][index],
+                                                     lineLength(d, index), linePosition(d, row, col));
+            }
+        }
+    }
+}
 
+// Ход меняет формы только пустых клеток в пределах окна формы по 4 линиям через клетку хода.
+// Занятость клетки определяется по маскам: при отмене хода поле очищается уже после вызова.
+template <int N>
+void BasicGameLogic<N>::updateShapes(int row, int col) {
     for (int d = 0; d < 4; d++) {
-        int count = 1;  // Начальное количество в цепочке равно 1 (считая сам ход)
-        int dx = directions[d][0], dy = directions[d][1];
-
-        // Смотрим в одном направлении.
-        int r = row + dx, c = col + dy;
-        while (r >= 0 && r < BOARD_SIZE && c >= 0 && c < BOARD_SIZE && board[r][c] == player) {
-            count++;
-            r += dx;
-            c += dy;
+        int index = lineIndex(d, row, col);
+        int pos = linePosition(d, row, col);
+        int length = lineLength(d, index);
+        uint32_t own = lines[black - 1][d][index];
+        uint32_t opp = lines[2 - black][d][index];
+        int last = std::min(length - 1, pos + RenjuRules::WINDOW);
+        for (int p = std::max(0, pos - RenjuRules::WINDOW); p <= last; p++) {
+            bool occupied = (((own | opp) >> p) & 1) != 0;
+            shapes[d][lineCell(d, index, p)] = occupied ? 0 : RenjuRules::lineShape(own, opp, length, p);
         }
-        // Смотрим в противоположном направлении.
-        r = row - dx, c = col - dy;
-        while (r >= 0 && r < BOARD_SIZE && c >= 0 && c < BOARD_SIZE && board[r][c] == player) {
-            count++;
-            r -= dx;
-            c -= dy;
+    }
+}
+
+template <int N>
+bool BasicGameLogic<N>::isForbidden(int row, int col, Player player) const {
+    if (!hasForbiddenMoves(player) || !isMoveValid(row, col))
+        return false;
+    return RenjuRules::isForbidden(*this, row, col);
+}
+
+template <int N>
+void BasicGameLogic<N>::setCandidateRadius(int radius) {
+    if (radius < 1)
+        radius = 1;
+    if (radius > MAX_CANDIDATE_RADIUS)
+        radius = MAX_CANDIDATE_RADIUS;
+    candidateRadius = radius;
+    rebuildFrontier();
+}
+
+// Переключает бит клетки во всех 4 линиях игрока и Zobrist-ключи клетки во всех образах позиции.
+// До и после изменения проверяется наличие пяти в ряд на каждой линии,
+// чтобы поддерживать счётчик fiveLines без полного обхода доски;
+// затем обновляется кэш оценок этих линий.
+template <int N>
+void BasicGameLogic<N>::toggleStone(int row, int col, Player player) {
+    int p = player - 1;
+    for (int d = 0; d < 4; d++) {
+        uint32_t &mask = lines[p][d][lineIndex(d, row, col)];
+        bool hadFive = winningFives(mask, p) != 0;
+        mask ^= 1u << linePosition(d, row, col);
+        bool hasFive = winningFives(mask, p) != 0;
+        fiveLines[p] += int(hasFive) - int(hadFive);
+    }
+    const ZobristKeys<N> &keys = zobristKeys<N>();
+    int cell = row * BOARD_SIZE + col;
+    for (int s = 0; s < SYMMETRY_COUNT; s++) {
+        symmetricHashes[0][s] ^= keys.symmetric[s][p][cell];
+        symmetricHashes[1][s] ^= keys.symmetric[s][1 - p][cell];
+    }
+
+    // Пересчитываем оценки только тех линий, которые проходят через клетку.
+    for (int d = 0; d < 4; d++) {
+        int index = lineIndex(d, row, col);
+        int score = PatternEvaluator::evaluateLine(*this, d, index);
+        evaluationScore += score - lineScores[d][index];
+        lineScores[d][index] = score;
+    }
+    if (rules == Renju)
+        updateShapes(row, col);
+}
+
+// Ключ очереди хода минимизирующего игрока.
+template <int N>
+uint64_t BasicGameLogic<N>::sideToMoveKey() {
+    return zobristKeys<N>().side;
+}
+
+// Наименьший из хешей 8 образов позиции; цвета переставляются, если ходит Human.
+// В рэндзю цвета неравноправны, поэтому ключ различает ещё и цвет того, кто ходит.
+template <int N>
+uint64_t BasicGameLogic<N>::canonicalHash(Player side, int &symmetry) const {
+    const uint64_t *hashes = symmetricHashes[side == AI ? 0 : 1];
+    symmetry = 0;
+    for (int s = 1; s < SYMMETRY_COUNT; s++) {
+        if (hashes[s] < hashes[symmetry])
+            symmetry = s;
+    }
+    if (rules == Renju && side == black)
+        return hashes[symmetry] ^ zobristKeys<N>().blackToMove;
+    return hashes[symmetry];
+}
+
+// Совпадение хешей образа и позиции проверяется ещё и по полю, чтобы коллизия хешей
+// не объявила несимметричную позицию симметричной.
+template <int N>
+int BasicGameLogic<N>::symmetryMask() const {
+    int mask = 1;
+    for (int s = 1; s < SYMMETRY_COUNT; s++) {
+        if (symmetricHashes[0][s] != symmetricHashes[0][0])
+            continue;
+        bool same = true;
+        for (int cell = 0; cell < CELL_COUNT && same; cell++) {
+            int image = transformCell(s, cell);
+            same = board[cell / BOARD_SIZE][cell % BOARD_SIZE] == board[image / BOARD_SIZE][image % BOARD_SIZE];
         }
-        // Если найдено 5 или более подряд, игрок выигрывает.
-        if (count >= 5)
+        if (same)
+            mask |= 1 << s;
+    }
+    return mask;
+}
+
+template <int N>
+int BasicGameLogic<N>::transformCell(int symmetry, int cell) {
+    const int last = BOARD_SIZE - 1;
+    int row = cell / BOARD_SIZE;
+    int col = cell % BOARD_SIZE;
+    int r = row, c = col;
+    switch (symmetry) {
+    case 1: r = col;        c = last - row; break; // поворот на 90
+    case 2: r = last - row; c = last - col; break; // поворот на 180
+    case 3: r = last - col; c = row;        break; // поворот на 270
+    case 4: r = row;        c = last - col; break; // отражение слева направо
+    case 5: r = last - row; c = col;        break; // отражение сверху вниз
+    case 6: r = col;        c = row;        break; // главная диагональ
+    case 7: r = last - col; c = last - row; break; // побочная диагональ
+    default: break;
+    }
+    return r * BOARD_SIZE + c;
+}
+
+// Zobrist-ключ камня: хеш позиции равен XOR ключей всех камней на доске.
+template <int N>
+uint64_t BasicGameLogic<N>::stoneKey(Player player, int row, int col) {
+    return zobristKeys<N>().cell[player - 1][row][col];
+}
+
+// Проверяет, выиграл ли игрок, сделав ход в точке (row, col).
+// Для каждого из 4 направлений берётся битовая маска линии (с учётом самого хода)
+// и ищутся выигрышные по правилам отрезки из пяти битов, покрывающие позицию хода.
+template <int N>
+bool BasicGameLogic<N>::checkWin(int row, int col, Player player) const {
+    if (row < 0 || row >= BOARD_SIZE || col < 0 || col >= BOARD_SIZE || player == None)
+        return false;
+    int p = player - 1;
+    for (int d = 0; d < 4; d++) {
+        int pos = linePosition(d, row, col);
+        uint32_t mask = lines[p][d][lineIndex(d, row, col)] | (1u << pos);
+        // Отрезок, начинающийся в позиции s, покрывает pos при pos - 4 <= s <= pos.
+        uint32_t around = (0x1Fu << pos) >> 4;
+        if (winningFives(mask, p) & around)
             return true;
     }
     return false;
 }
 
 // Проверяет игровое поле на наличие победителя.
-// Проходит по всем клеткам и, если клетка не пуста, вызывает checkWin.
-// Если найден победитель, возвращает номер игрока.
-int GameLogic::checkWinner() const {
-    for (int i = 0; i < BOARD_SIZE; i++){
-        for (int j = 0; j < BOARD_SIZE; j++){
-            int player = board[i][j];
-            if (player != None && checkWin(i, j, static_cast<Player>(player)))
-                return player;
-        }
-    }
+// Счётчики линий с пятью в ряд обновляются при каждом ходе, поэтому проверка мгновенная.
+template <int N>
+int BasicGameLogic<N>::checkWinner() const {
+    if (fiveLines[Human - 1] > 0)
+        return Human;
+    if (fiveLines[AI - 1] > 0)
+        return AI;
     return None;
 }
 
 // Возвращает вектор пар координат для всех пустых клеток (доступных ходов).
-std::vector<std::pair<int, int>> GameLogic::getAvailableMoves() const {
+template <int N>
+std::vector<std::pair<int, int>> BasicGameLogic<N>::getAvailableMoves() const {
     std::vector<std::pair<int, int>> moves;
     for (int i = 0; i < BOARD_SIZE; i++){
         for (int j = 0; j < BOARD_SIZE; j++){
@@ -85,3 +438,77 @@ std::vector<std::pair<int, int>> GameLogic::getAvailableMoves() const {
     }
     return moves;
 }
+
+// Возвращает пустые клетки фронтира; на пустой доске – центр поля.
+template <int N>
+std::vector<std::pair<int, int>> BasicGameLogic<N>::getCandidateMoves() const {
+    std::vector<std::pair<int, int>> moves;
+    if (stones == 0) {
+        moves.push_back(std::make_pair(BOARD_SIZE / 2, BOARD_SIZE / 2));
+        return moves;
+    }
+    moves.reserve(frontierSize);
+    for (int i = 0; i < frontierSize; i++)
+        moves.push_back(std::make_pair(frontier[i] / BOARD_SIZE, frontier[i] % BOARD_SIZE));
+    return moves;
+}
+
+// Возвращает битовую маску камней игрока на линии.
+template <int N>
+uint32_t BasicGameLogic<N>::lineMask(Player player, int dir, int index) const {
+    if (player == None)
+        return 0;
+    return lines[player - 1][dir][index];
+}
+
+// Номер линии: для строки – номер строки, для столбца – номер столбца,
+// для диагоналей – смещённая разность или сумма координат.
+template <int N>
+int BasicGameLogic<N>::lineIndex(int dir, int row, int col) {
+    switch (dir) {
+    case Horizontal:   return row;
+    case Vertical:     return col;
+    case Diagonal:     return row - col + BOARD_SIZE - 1;
+    default:           return row + col;
+    }
+}
+
+// Позиция клетки на линии; нумерация каждой линии начинается с нуля.
+template <int N>
+int BasicGameLogic<N>::linePosition(int dir, int row, int col) {
+    switch (dir) {
+    case Horizontal:   return col;
+    case Vertical:     return row;
+    case Diagonal:     return std::min(row, col);
+    default:           return col - std::max(0, row + col - (BOARD_SIZE - 1));
+    }
+}
+
+// Длина линии: строки и столбцы имеют длину BOARD_SIZE, диагонали – от 1 до BOARD_SIZE.
+template <int N>
+int BasicGameLogic<N>::lineLength(int dir, int index) {
+    if (dir == Horizontal || dir == Vertical)
+        return BOARD_SIZE;
+    int offset = index - (BOARD_SIZE - 1);
+    return BOARD_SIZE - (offset < 0 ? -offset : offset);
+}
+
+template <int N>
+int BasicGameLogic<N>::lineCell(int dir, int index, int pos) {
+    switch (dir) {
+    case Horizontal:   return index * BOARD_SIZE + pos;
+    case Vertical:     return pos * BOARD_SIZE + index;
+    case Diagonal: {
+        int shift = index - (BOARD_SIZE - 1); // row - col
+        return shift >= 0 ? (pos + shift) * BOARD_SIZE + pos : pos * BOARD_SIZE + pos - shift;
+    }
+    default: {
+        int col = pos + std::max(0, index - (BOARD_SIZE - 1));
+        return (index - col) * BOARD_SIZE + col;
+    }
+    }
+}
+
+template class BasicGameLogic<15>;
+template class BasicGameLogic<19>;
+template class BasicGameLogic<20>;
@@ -0,0 +1,269 @@
+#include "../include/game-record.h"
+#include <cstring>
+
+namespace {
+
+const char MAGIC[8] = {'G', 'M', 'K', 'S', 'A', 'V', 'E', '\0'};
+
+GameLogic::Player opponentOf(GameLogic::Player player) {
+    return (player == GameLogic::Human) ? GameLogic::AI : GameLogic::Human;
+}
+
+// Проверяет заголовок; version – версия файла, boardSize – размер доски.
+bool checkHeader(const uint8_t *bytes, std::size_t size, int &version, int &boardSize) {
+    if (size < std::size_t(GameArchive::HEADER_SIZE) || std::memcmp(bytes, MAGIC, sizeof(MAGIC)) != 0)
+        return false;
+    version = bytes[8] | (bytes[9] << 8);
+    boardSize = bytes[10];
+    return boardSize >= 5 && boardSize <= GameArchive::MAX_BOARD_SIZE;
+}
+
+// Ходы на доске, где клеток больше, чем значений до GAME_START, занимают два байта.
+bool wideCells(int boardSize) {
+    return boardSize * boardSize > GameArchive::GAME_START;
+}
+
+// Записывает ход в клетку cell; возвращает число байтов (1 или 2).
+int encodeCell(int cell, int boardSize, uint8_t *bytes) {
+    if (!wideCells(boardSize)) {
+        bytes[0] = uint8_t(cell);
+        return 1;
+    }
+    bytes[0] = uint8_t(cell >> 8);
+    bytes[1] = uint8_t(cell & 0xFF);
+    return 2;
+}
+
+// Записывает партию в поток байтов.
+void encodeGame(const SavedGame &game, std::vector<uint8_t> &bytes) {
+    bytes.push_back(uint8_t(GameArchive::GAME_START));
+    bytes.push_back(uint8_t(game.firstPlayer));
+    for (const GameLogic::RecordedMove &move : game.moves) {
+        uint8_t cell[2];
+        int count = encodeCell(move.row * game.boardSize + move.col, game.boardSize, cell);
+        bytes.insert(bytes.end(), cell, cell + count);
+    }
+    if (game.finished) {
+        bytes.push_back(uint8_t(GameArchive::GAME_END));
+        bytes.push_back(uint8_t(game.winner));
+    }
+}
+
+} // namespace
+
+GameLogic::Player SavedGame::sideToMove() const {
+    return (moves.size() % 2 == 0) ? firstPlayer : opponentOf(firstPlayer);
+}
+
+template <int N>
+BasicGameLogic<N> SavedGame::position() const {
+    BasicGameLogic<N> game;
+    for (const GameLogic::RecordedMove &move : moves)
+        game.playMove(move.row, move.col, static_cast<GameLogic::Player>(move.player));
+    return game;
+}
+
+template BasicGameLogic<15> SavedGame::position<15>() const;
+template BasicGameLogic<19> SavedGame::position<19>() const;
+template BasicGameLogic<20> SavedGame::position<20>() const;
+
+/**
+ * @brief load Читает файл целиком одним вызовом и разбирает поток байтов за один проход.
+ *
+ * Ходы проверяются без воспроизведения партии: клетка должна существовать и быть свободной.
+ */
+bool GameArchive::load(const std::string &path, std::vector<SavedGame> &games, std::string &error) {
+    std::FILE *file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        error = "не удалось открыть " + path;
+        return false;
+    }
+    std::vector<uint8_t> bytes;
+    uint8_t buffer[65536];
+    std::size_t count;
+    while ((count = std::fread(buffer, 1, sizeof(buffer), file)) > 0)
+        bytes.insert(bytes.end(), buffer, buffer + count);
+    std::fclose(file);
+
+    int version = 0;
+    int boardSize = 0;
+    if (!checkHeader(bytes.data(), bytes.size(), version, boardSize)) {
+        error = path + ": не файл партий";
+        return false;
+    }
+    if (version > FORMAT_VERSION) {
+        error = path + ": версия формата " + std::to_string(version) + " не поддерживается";
+        return false;
+    }
+
+    SavedGame *current = nullptr;
+    const bool wide = wideCells(boardSize);
+    const int cellCount = boardSize * boardSize;
+    bool occupied[MAX_BOARD_SIZE * MAX_BOARD_SIZE] = {};
+    for (std::size_t i = HEADER_SIZE; i < bytes.size(); i++) {
+        uint8_t code = bytes[i];
+        if (code == GAME_START || code == GAME_END) {
+            if (i + 1 == bytes.size())
+                break; // служебный байт без параметра – запись оборвалась
+            uint8_t value = bytes[++i];
+            if (code == GAME_START && (value == GameLogic::Human || value == GameLogic::AI)) {
+                // Предыдущая партия без GAME_END остаётся незавершённой.
+                games.emplace_back();
+                current = &games.back();
+                current->boardSize = boardSize;
+                current->firstPlayer = static_cast<GameLogic::Player>(value);
+                std::memset(occupied, 0, sizeof(occupied));
+                continue;
+            }
+            if (code == GAME_END && current && value <= GameLogic::AI) {
+                current->winner = value;
+                current->finished = true;
+                current = nullptr;
+                continue;
+            }
+        } else if (code == UNDO) {
+            if (current && !current->moves.empty()) {
+                const GameLogic::RecordedMove &move = current->moves.back();
+                occupied[move.row * boardSize + move.col] = false;
+                current->moves.pop_back();
+                continue;
+            }
+        } else if (code < GAME_START) {
+            if (wide && i + 1 == bytes.size())
+                break; // от двухбайтового хода записан только первый байт
+            int cell = wide ? (code << 8) | bytes[++i] : code;
+            if (cell < cellCount && current && !occupied[cell]) {
+                occupied[cell] = true;
+                GameLogic::Player player = current->sideToMove();
+                current->moves.push_back(GameLogic::RecordedMove{uint8_t(cell / boardSize),
+                                                                 uint8_t(cell % boardSize),
+                                                                 uint8_t(player)});
+                continue;
+            }
+        }
+        error = path + ": повреждённые данные в байте " + std::to_string(i);
+        return false;
+    }
+    return true;
+}
+
+bool GameArchive::save(const std::string &path, const std::vector<SavedGame> &games) {
+    std::FILE *file = std::fopen(path.c_str(), "wb");
+    if (!file)
+        return false;
+    int boardSize = games.empty() ? GameLogic::BOARD_SIZE : games[0].boardSize;
+    std::vector<uint8_t> bytes;
+    for (const SavedGame &game : games) {
+        if (game.boardSize != boardSize) {
+            std::fclose(file);
+            return false;
+        }
+        encodeGame(game, bytes);
+    }
+    bool ok = writeHeader(file, boardSize) && std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    return std::fclose(file) == 0 && ok;
+}
+
+std::string GameArchive::toText(const SavedGame &game) {
+    std::string text;
+    for (const GameLogic::RecordedMove &move : game.moves) {
+        if (!text.empty())
+            text += ' ';
+        text += std::to_string(move.row) + "," + std::to_string(move.col);
+    }
+    if (!text.empty())
+        text += ' ';
+    text += "# ";
+    if (!game.finished)
+        text += "не окончена";
+    else if (game.winner == GameLogic::None)
+        text += "ничья";
+    else
+        text += (game.winner == game.firstPlayer) ? "победа первого игрока" : "победа второго игрока";
+    return text;
+}
+
+bool GameArchive::exportText(const std::string &path, const std::vector<SavedGame> &games) {
+    std::FILE *file = std::fopen(path.c_str(), "w");
+    if (!file)
+        return false;
+    bool ok = std::fputs("# gomoku-qt: одна партия в строке, ходы row,col; первый ход – первого игрока\n", file) >= 0;
+    for (const SavedGame &game : games)
+        ok = ok && std::fprintf(file, "%s\n", toText(game).c_str()) >= 0;
+    return std::fclose(file) == 0 && ok;
+}
+
+bool GameArchive::isArchive(const std::string &path) {
+    return archiveBoardSize(path) != 0;
+}
+
+int GameArchive::archiveBoardSize(const std::string &path) {
+    std::FILE *file = std::fopen(path.c_str(), "rb");
+    if (!file)
+        return 0;
+    uint8_t header[HEADER_SIZE];
+    std::size_t size = std::fread(header, 1, sizeof(header), file);
+    std::fclose(file);
+    int version, boardSize;
+    return checkHeader(header, size, version, boardSize) ? boardSize : 0;
+}
+
+bool GameArchive::writeHeader(std::FILE *file, int boardSize) {
+    uint8_t header[HEADER_SIZE] = {};
+    std::memcpy(header, MAGIC, sizeof(MAGIC));
+    header[8] = uint8_t(FORMAT_VERSION & 0xFF);
+    header[9] = uint8_t(FORMAT_VERSION >> 8);
+    header[10] = uint8_t(boardSize);
+    return std::fwrite(header, 1, sizeof(header), file) == sizeof(header);
+}
+
+GameRecorder::~GameRecorder() {
+    close();
+}
+
+// Существующий файл проверяется по заголовку; новый или пустой файл получает заголовок.
+bool GameRecorder::open(const std::string &path, int size) {
+    close();
+    boardSize = size;
+    file = std::fopen(path.c_str(), "ab");
+    if (!file)
+        return false;
+    std::fseek(file, 0, SEEK_END);
+    long length = std::ftell(file);
+    bool ok = (length == 0) ? GameArchive::writeHeader(file, boardSize) && std::fflush(file) == 0
+                            : GameArchive::archiveBoardSize(path) == boardSize;
+    if (!ok)
+        close();
+    return ok;
+}
+
+void GameRecorder::close() {
+    if (file)
+        std::fclose(file);
+    file = nullptr;
+}
+
+bool GameRecorder::beginGame(GameLogic::Player firstPlayer) {
+    uint8_t bytes[2] = {GameArchive::GAME_START, uint8_t(firstPlayer)};
+    return write(bytes, 2);
+}
+
+bool GameRecorder::appendMove(int row, int col) {
+    uint8_t cell[2];
+    int count = encodeCell(row * boardSize + col, boardSize, cell);
+    return write(cell, std::size_t(count));
+}
+
+bool GameRecorder::appendUndo() {
+    uint8_t code = GameArchive::UNDO;
+    return write(&code, 1);
+}
+
+bool GameRecorder::endGame(int winner) {
+    uint8_t bytes[2] = {GameArchive::GAME_END, uint8_t(winner)};
+    return write(bytes, 2);
+}
+
+bool GameRecorder::write(const uint8_t *bytes, std::size_t count) {
+    return file && std::fwrite(bytes, 1, count, file) == count && std::fflush(file) == 0;
+}
@@ -0,0 +1,258 @@
+#include "../include/opening-book.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char MAGIC[8] = {'G', 'M', 'K', 'B', 'O', 'O', 'K', '\0'};
+
+// Числа в файле хранятся в little-endian и читаются побайтно, независимо от платформы.
+uint64_t readLe(const unsigned char *bytes, int size) {
+    uint64_t value = 0;
+    for (int i = size - 1; i >= 0; i--)
+        value = (value << 8) | bytes[i];
+    return value;
+}
+
+void writeLe(std::ostream &out, uint64_t value, int size) {
+    for (int i = 0; i < size; i++) {
+        out.put(char(value & 0xFF));
+        value >>= 8;
+    }
+}
+
+} // namespace
+
+OpeningBook::~OpeningBook() {
+    close();
+}
+
+/**
+ * @brief open Отображает файл книги в память и проверяет заголовок.
+ *
+ * Записи не копируются: страницы файла подгружаются системой при первом обращении,
+ * поэтому открытие книги любого размера занимает микросекунды.
+ */
+bool OpeningBook::open(const std::string &path) {
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER fileSize;
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart >= HEADER_SIZE)
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+    void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle = file;
+    mappingHandle = mapping;
+    data = static_cast<const unsigned char *>(view);
+    length = std::size_t(fileSize.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat info;
+    void *view = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size >= HEADER_SIZE)
+        view = mmap(nullptr, std::size_t(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // Отображение остаётся действительным и после закрытия дескриптора.
+    if (view == MAP_FAILED)
+        return false;
+    data = static_cast<const unsigned char *>(view);
+    length = std::size_t(info.st_size);
+#endif
+
+    std::size_t count = std::size_t(readLe(data + 12, 4));
+    uint64_t size = readLe(data + 16, 4);
+    if (std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0 || readLe(data + 8, 4) != FORMAT_VERSION ||
+        size < 5 || size > 32 || count > (length - HEADER_SIZE) / ENTRY_SIZE) {
+        close();
+        return false;
+    }
+    entryCount = count;
+    bookBoardSize = int(size);
+    return true;
+}
+
+void OpeningBook::close() {
+    if (data) {
+#ifdef _WIN32
+        UnmapViewOfFile(data);
+        CloseHandle(static_cast<HANDLE>(mappingHandle));
+        CloseHandle(static_cast<HANDLE>(fileHandle));
+#else
+        munmap(const_cast<unsigned char *>(data), length);
+#endif
+    }
+    data = nullptr;
+    length = 0;
+    entryCount = 0;
+    bookBoardSize = 0;
+    fileHandle = nullptr;
+    mappingHandle = nullptr;
+}
+
+OpeningBook::Entry OpeningBook::entryAt(std::size_t index) const {
+    const unsigned char *bytes = data + HEADER_SIZE + index * ENTRY_SIZE;
+    Entry entry;
+    entry.key = readLe(bytes, 8);
+    entry.move = int(readLe(bytes + 8, 2));
+    entry.weight = int(readLe(bytes + 10, 2));
+    entry.score = int(int16_t(uint16_t(readLe(bytes + 12, 2))));
+    return entry;
+}
+
+/**
+ * @brief entries Двоичный поиск первой записи с ключом позиции и перевод ходов
+ * из канонической системы координат в координаты game.
+ */
+template <int N>
+std::vector<OpeningBook::Entry> OpeningBook::entries(const BasicGameLogic<N> &game,
+                                                     GameLogicBase::Player side) const {
+    std::vector<Entry> found;
+    if (!data || bookBoardSize != N)
+        return found;
+    int symmetry;
+    uint64_t key = game.canonicalHash(side, symmetry);
+
+    std::size_t low = 0, high = entryCount;
+    while (low < high) {
+        std::size_t middle = low + (high - low) / 2;
+        if (entryAt(middle).key < key)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    for (std::size_t i = low; i < entryCount; i++) {
+        Entry entry = entryAt(i);
+        if (entry.key != key)
+            break;
+        if (entry.move >= BasicGameLogic<N>::CELL_COUNT)
+            continue;
+        entry.move = BasicGameLogic<N>::transformCell(GameLogicBase::inverseSymmetry(symmetry), entry.move);
+        found.push_back(entry);
+    }
+    return found;
+}
+
+template <int N>
+bool OpeningBook::probe(const BasicGameLogic<N> &game, GameLogicBase::Player side, std::pair<int, int> &move) const {
+    // Записи уже упорядочены по убыванию веса; совпадение 64-битных ключей разных
+    // позиций маловероятно, но занятая клетка всё равно отбрасывается.
+    for (const Entry &entry : entries(game, side)) {
+        int row = entry.move / N;
+        int col = entry.move % N;
+        if (game.isMoveValid(row, col)) {
+            move = std::make_pair(row, col);
+            return true;
+        }
+    }
+    return false;
+}
+
+#define GOMOKU_INSTANTIATE_BOOK(N)                                                                       \
+    template std::vector<OpeningBook::Entry> OpeningBook::entries<N>(const BasicGameLogic<N> &,          \
+                                                                     GameLogicBase::Player) const;       \
+    template bool OpeningBook::probe<N>(const BasicGameLogic<N> &, GameLogicBase::Player,                \
+                                        std::pair<int, int> &) const;
+GOMOKU_INSTANTIATE_BOOK(15)
+GOMOKU_INSTANTIATE_BOOK(19)
+GOMOKU_INSTANTIATE_BOOK(20)
+
+void OpeningBookBuilder::addMove(const GameLogic &game, GameLogic::Player side, std::pair<int, int> move,
+                                 int weight, int score) {
+    int symmetry;
+    uint64_t key = game.canonicalHash(side, symmetry);
+    int cell = GameLogic::transformCell(symmetry, move.first * GameLogic::BOARD_SIZE + move.second);
+    Stats &stats = moves[std::make_pair(key, cell)];
+    stats.weight += weight;
+    if (score != 0)
+        stats.score = score;
+}
+
+bool OpeningBookBuilder::addGame(const std::vector<std::pair<int, int>> &gameMoves, int maxPlies) {
+    // Сначала партия проигрывается до конца, чтобы узнать победителя.
+    GameLogic game;
+    GameLogic::Player player = GameLogic::Human;
+    int winner = GameLogic::None;
+    for (const auto &move : gameMoves) {
+        if (winner != GameLogic::None || !game.makeMove(move.first, move.second, player))
+            return false;
+        winner = game.checkWinner();
+        player = (player == GameLogic::Human) ? GameLogic::AI : GameLogic::Human;
+    }
+
+    game.reset();
+    player = GameLogic::Human;
+    int plies = std::min<int>(maxPlies, int(gameMoves.size()));
+    for (int i = 0; i < plies; i++) {
+        const auto &move = gameMoves[i];
+        int weight = (winner == GameLogic::None) ? 1 : (winner == player ? 2 : 0);
+        if (weight > 0)
+            addMove(game, player, move, weight);
+        game.makeMove(move.first, move.second, player);
+        player = (player == GameLogic::Human) ? GameLogic::AI : GameLogic::Human;
+    }
+    return true;
+}
+
+bool OpeningBookBuilder::save(const std::string &path, int minWeight) const {
+    std::vector<OpeningBook::Entry> entries;
+    for (const auto &item : moves) {
+        if (item.second.weight < minWeight)
+            continue;
+        OpeningBook::Entry entry;
+        entry.key = item.first.first;
+        entry.move = item.first.second;
+        entry.weight = int(std::min<long long>(item.second.weight, 0xFFFF));
+        entry.score = std::max(-32768, std::min(32767, item.second.score));
+        entries.push_back(entry);
+    }
+    std::sort(entries.begin(), entries.end(), [](const OpeningBook::Entry &a, const OpeningBook::Entry &b) {
+        if (a.key != b.key)
+            return a.key < b.key;
+        if (a.weight != b.weight)
+            return a.weight > b.weight;
+        return a.move < b.move;
+    });
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+        return false;
+    out.write(MAGIC, sizeof(MAGIC));
+    writeLe(out, OpeningBook::FORMAT_VERSION, 4);
+    writeLe(out, entries.size(), 4);
+    writeLe(out, GameLogic::BOARD_SIZE, 4);
+    writeLe(out, 0, 4);
+    for (const OpeningBook::Entry &entry : entries) {
+        writeLe(out, entry.key, 8);
+        writeLe(out, uint64_t(entry.move), 2);
+        writeLe(out, uint64_t(entry.weight), 2);
+        writeLe(out, uint16_t(int16_t(entry.score)), 2);
+        writeLe(out, 0, 2);
+    }
+    return bool(out);
+}
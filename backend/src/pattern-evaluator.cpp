@@ -0,0 +1,188 @@
+#include "../include/pattern-evaluator.h"
+#include "../include/game-logic.h"
+
+// Исходная таблица оценок цепочек: длина и число открытых концов.
+int PatternEvaluator::chainScore(int count, int openEnds) {
+    if (count >= 5)
+        return FIVE_SCORE;
+    if (count == 4)
+        return (openEnds == 2) ? 10000 : 1000;
+    if (count == 3)
+        return (openEnds == 2) ? 1000 : 100;
+    if (count == 2)
+        return (openEnds == 2) ? 100 : 10;
+    return 10;
+}
+
+/**
+ * @brief scoreLine Оценивает линию для одного игрока.
+ *
+ * Сначала линия разбивается на максимальные цепочки камней игрока, каждая из которых
+ * оценивается по chainScore. Затем окнами из 5 и 6 клеток ищутся разорванные шаблоны.
+ */
+int PatternEvaluator::scoreLine(uint32_t own, uint32_t opp, int length, bool brokenPatterns, bool exactFive) {
+    if (own == 0)
+        return 0;
+    uint32_t valid = (1u << length) - 1;
+    uint32_t empty = valid & ~own & ~opp;
+
+    int score = 0;
+    int pos = 0;
+    while (pos < length) {
+        if (!((own >> pos) & 1)) {
+            pos++;
+            continue;
+        }
+        int start = pos;
+        while (pos < length && ((own >> pos) & 1))
+            pos++;
+        int openEnds = 0;
+        if (start > 0 && ((empty >> (start - 1)) & 1))
+            openEnds++;
+        if (pos < length && ((empty >> pos) & 1))
+            openEnds++;
+        // Длинный ряд, который не выигрывает, уже ничем не станет.
+        if (!exactFive || pos - start <= 5)
+            score += chainScore(pos - start, openEnds);
+    }
+
+    if (!brokenPatterns)
+        return score;
+
+    // Разорванная четвёрка: окно из 5 клеток, 4 камня и один пустой разрыв внутри.
+    for (int s = 0; s + 5 <= length; s++) {
+        uint32_t window = (own >> s) & 0x1F;
+        uint32_t gaps = (empty >> s) & 0x1F;
+        if ((window == 0x1D || window == 0x1B || window == 0x17) && (window | gaps) == 0x1F)
+            score += BROKEN_FOUR_BONUS;
+    }
+    // Открытая разорванная тройка: окно из 6 клеток с пустыми краями и серединой X_XX или XX_X.
+    for (int s = 0; s + 6 <= length; s++) {
+        if (!((empty >> s) & 1) || !((empty >> (s + 5)) & 1))
+            continue;
+        uint32_t middle = (own >> (s + 1)) & 0xF;
+        uint32_t gaps = (empty >> (s + 1)) & 0xF;
+        if ((middle == 0xD || middle == 0xB) && (middle | gaps) == 0xF)
+            score += BROKEN_THREE_BONUS;
+    }
+    return score;
+}
+
+template <int N>
+int PatternEvaluator::evaluateLine(const BasicGameLogic<N> &game, int dir, int index, bool brokenPatterns) {
+    int length = BasicGameLogic<N>::lineLength(dir, index);
+    uint32_t ai = game.lineMask(GameLogicBase::AI, dir, index);
+    uint32_t human = game.lineMask(GameLogicBase::Human, dir, index);
+    return scoreLine(ai, human, length, brokenPatterns, !game.overlineWins(GameLogicBase::AI)) -
+           scoreLine(human, ai, length, brokenPatterns, !game.overlineWins(GameLogicBase::Human));
+}
+
+template <int N>
+int PatternEvaluator::evaluateBoard(const BasicGameLogic<N> &game, bool brokenPatterns) {
+    int score = 0;
+    for (int d = 0; d < 4; d++) {
+        int count = (d == GameLogicBase::Horizontal || d == GameLogicBase::Vertical)
+                        ? BasicGameLogic<N>::BOARD_SIZE : BasicGameLogic<N>::LINE_COUNT;
+        for (int k = 0; k < count; k++)
+            score += evaluateLine(game, d, k, brokenPatterns);
+    }
+    return score;
+}
+
+/**
+ * @brief lineThreat Определяет угрозу на линии по окнам, проходящим через позицию хода.
+ *
+ * Пятёрка – пять битов подряд; открытая четвёрка – _XXXX_; четвёрка – окно из 5 клеток
+ * без камней противника с 4 камнями игрока; открытая тройка – окно из 6 клеток с пустыми
+ * краями и 3 камнями игрока среди 4 средних клеток. При exactFive окно пятёрки и четвёрки
+ * не должно продолжаться камнями игрока с краёв.
+ */
+PatternEvaluator::Threat PatternEvaluator::lineThreat(uint32_t own, uint32_t opp, int length, int pos,
+                                                      bool exactFive) {
+    uint32_t valid = (1u << length) - 1;
+    // Любая угроза требует хотя бы 3 камней игрока в пределах 4 клеток от хода.
+    uint32_t nearby = own & ((0x1FFu << pos) >> 4) & valid;
+    nearby &= nearby - 1;
+    if ((nearby & (nearby - 1)) == 0)
+        return NoThreat;
+    uint32_t empty = valid & ~own & ~opp;
+
+    uint32_t fives = exactFive ? GameLogicBase::exactFiveStarts(own) : GameLogicBase::fiveStarts(own);
+    if (fives & ((0x1Fu << pos) >> 4))
+        return Five;
+    // Камни игрока вплотную к окну из 5 клеток, начинающемуся в s (для exactFive).
+    auto extended = [own](int s) { return ((own >> (s + 5)) & 1) || (s > 0 && ((own >> (s - 1)) & 1)); };
+
+    Threat best = NoThreat;
+    for (int s = pos - 4; s <= pos; s++) {
+        if (s < 0 || s + 5 > length)
+            continue;
+        uint32_t window = (own >> s) & 0x1F;
+        uint32_t gaps = (empty >> s) & 0x1F;
+        if ((window | gaps) != 0x1F)
+            continue;  // в окне есть камень противника
+        if (window == 0x1F)
+            continue;
+        if (exactFive && extended(s))
+            continue;
+        int stones = 0;
+        for (uint32_t w = window; w; w &= w - 1)
+            stones++;
+        if (stones == 4) {
+            // Открытая четвёрка: окно _XXXX или XXXX_ вместе с соседней пустой клеткой.
+            bool open = (window == 0x1E && s + 5 < length && ((empty >> (s + 5)) & 1) &&
+                         !(exactFive && extended(s + 1))) ||
+                        (window == 0x0F && s > 0 && ((empty >> (s - 1)) & 1) && !(exactFive && extended(s - 1)));
+            if (open)
+                return OpenFour;
+            best = Four;
+        }
+    }
+    if (best != NoThreat)
+        return best;
+
+    for (int s = pos - 4; s <= pos - 1; s++) {
+        if (s < 0 || s + 6 > length)
+            continue;
+        if (!((empty >> s) & 1) || !((empty >> (s + 5)) & 1))
+            continue;
+        uint32_t middle = (own >> (s + 1)) & 0xF;
+        uint32_t gaps = (empty >> (s + 1)) & 0xF;
+        if ((middle | gaps) != 0xF)
+            continue;
+        if (middle == 0x7 || middle == 0xE || middle == 0xD || middle == 0xB)
+            return OpenThree;
+    }
+    return NoThreat;
+}
+
+template <int N>
+PatternEvaluator::Threat PatternEvaluator::moveThreat(const BasicGameLogic<N> &game, int row, int col,
+                                                      GameLogicBase::Player player) {
+    using Game = BasicGameLogic<N>;
+    GameLogicBase::Player opponent = (player == Game::AI) ? Game::Human : Game::AI;
+    Threat best = NoThreat;
+    for (int d = 0; d < 4; d++) {
+        int index = Game::lineIndex(d, row, col);
+        int pos = Game::linePosition(d, row, col);
+        uint32_t own = game.lineMask(player, d, index) | (1u << pos);
+        uint32_t opp = game.lineMask(opponent, d, index);
+        Threat threat = lineThreat(own, opp, Game::lineLength(d, index), pos, !game.overlineWins(player));
+        if (threat > best) {
+            best = threat;
+            if (best == Five)
+                break;
+        }
+    }
+    return best;
+}
+
+// Инстанцирования для размеров доски, с которыми собран GameLogic.
+#define GOMOKU_INSTANTIATE_EVALUATOR(N)                                                              \
+    template int PatternEvaluator::evaluateLine<N>(const BasicGameLogic<N> &, int, int, bool);       \
+    template int PatternEvaluator::evaluateBoard<N>(const BasicGameLogic<N> &, bool);                \
+    template PatternEvaluator::Threat PatternEvaluator::moveThreat<N>(const BasicGameLogic<N> &, int, int, \
+                                                                      GameLogicBase::Player);
+GOMOKU_INSTANTIATE_EVALUATOR(15)
+GOMOKU_INSTANTIATE_EVALUATOR(19)
+GOMOKU_INSTANTIATE_EVALUATOR(20)
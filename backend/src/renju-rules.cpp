@@ -0,0 +1,204 @@
+#include "../include/renju-rules.h"
+#include <algorithm>
+
+namespace {
+
+const int CENTER = RenjuRules::WINDOW;        // Клетка хода в окне.
+const int WINDOW_CELLS = 2 * CENTER + 1;      // Клеток в окне вместе с клеткой хода.
+const int SHAPE_COUNT = 59049;                // 3^10 окон без клетки хода.
+
+// Содержимое клетки окна; край доски не отличается от белого камня.
+enum WindowCell { Empty = 0, Black = 1, Blocked = 2 };
+
+// Длина ряда чёрных камней через клетку at.
+int blackRun(const int cells[], int at) {
+    int left = at, right = at;
+    while (left > 0 && cells[left - 1] == Black)
+        left--;
+    while (right < WINDOW_CELLS - 1 && cells[right + 1] == Black)
+        right++;
+    return right - left + 1;
+}
+
+// Пустые клетки, ход в которые даёт ряду через клетку хода ровно пять; возвращает их число.
+int fiveCells(int cells[], int found[]) {
+    int count = 0;
+    for (int q = 1; q < WINDOW_CELLS - 1; q++) {
+        if (cells[q] != Empty)
+            continue;
+        cells[q] = Black;
+        if (blackRun(cells, CENTER) == 5)
+            found[count++] = q;
+        cells[q] = Empty;
+    }
+    return count;
+}
+
+// Две клетки пятёрки на расстоянии 5 – это одна открытая четвёрка _XXXX_.
+bool isOpenFour(int count, const int found[]) {
+    return count == 2 && found[1] - found[0] == 5;
+}
+
+// Форма окна после хода чёрных в клетку CENTER.
+uint16_t computeShape(int cells[]) {
+    cells[CENTER] = Black;
+    int run = blackRun(cells, CENTER);
+    if (run == 5)
+        return RenjuRules::FiveBit;
+    if (run > 5)
+        return RenjuRules::OverlineBit;
+
+    int found[WINDOW_CELLS];
+    int count = fiveCells(cells, found);
+    if (count > 0) {
+        bool open = isOpenFour(count, found);
+        int fours = open ? 1 : std::min(count, 2);
+        return uint16_t((fours << RenjuRules::FourShift) | (open ? RenjuRules::OpenFourBit : 0));
+    }
+
+    // Тройка: ход в какую-то клетку окна даёт открытую четвёрку. Бит клетки – смещение от хода плюс 4.
+    int threes = 0;
+    for (int q = 1; q < WINDOW_CELLS - 1; q++) {
+        if (cells[q] != Empty)
+            continue;
+        cells[q] = Black;
+        count = fiveCells(cells, found);
+        if (isOpenFour(count, found))
+            threes |= 1 << (q - 1);
+        cells[q] = Empty;
+    }
+    return uint16_t(threes << RenjuRules::ThreeShift);
+}
+
+// Формы всех окон. Индекс окна – троичное число: разряд i – клетка i окна без клетки хода.
+struct ShapeTable {
+    uint16_t shapes[SHAPE_COUNT];
+    int ternary[32]; // 5 битов -> троичное число с теми же цифрами
+
+    ShapeTable() {
+        for (int bits = 0; bits < 32; bits++) {
+            ternary[bits] = 0;
+            for (int b = 4; b >= 0; b--)
+                ternary[bits] = ternary[bits] * 3 + ((bits >> b) & 1);
+        }
+        for (int index = 0; index < SHAPE_COUNT; index++) {
+            int cells[WINDOW_CELLS];
+            int rest = index;
+            int stones = 0; // Чёрные камни не дальше 4 клеток от хода.
+            for (int i = 0; i < WINDOW_CELLS; i++) {
+                if (i == CENTER)
+                    continue;
+                cells[i] = rest % 3;
+                rest /= 3;
+                stones += cells[i] == Black && i > 0 && i < WINDOW_CELLS - 1;
+            }
+            // Без двух чёрных камней рядом нет даже тройки.
+            shapes[index] = stones >= 2 ? computeShape(cells) : 0;
+        }
+    }
+
+    // Троичный индекс 10-битной маски окна.
+    int index(uint32_t bits) const { return ternary[bits & 31] + 243 * ternary[bits >> 5]; }
+};
+
+const ShapeTable &shapeTable() {
+    static const ShapeTable table;
+    return table;
+}
+
+// Смещение по строке и столбцу при сдвиге на одну позицию вдоль линии направления.
+const int ROW_STEP[4] = {0, 1, 1, -1};
+const int COL_STEP[4] = {1, 0, 1, 1};
+
+} // namespace
+
+/**
+ * @brief lineShape Вырезает из масок линии окно вокруг pos и берёт форму из таблицы.
+ *
+ * Бит i окна – клетка линии pos - WINDOW + i; клетки за краями линии считаются занятыми.
+ */
+uint16_t RenjuRules::lineShape(uint32_t black, uint32_t white, int length, int pos) {
+    const ShapeTable &table = shapeTable();
+    uint64_t valid = ((uint64_t(1) << length) - 1) << WINDOW;
+    uint64_t own = (uint64_t(black) << WINDOW) >> pos;
+    uint64_t blocked = ((uint64_t(white) << WINDOW) | ~valid) >> pos;
+    // Клетка хода (бит WINDOW) из окна выбрасывается.
+    uint32_t ownBits = uint32_t(own & 0x1F) | uint32_t((own >> (WINDOW + 1)) & 0x1F) << 5;
+    uint32_t blockedBits = uint32_t(blocked & 0x1F) | uint32_t((blocked >> (WINDOW + 1)) & 0x1F) << 5;
+    return table.shapes[table.index(ownBits) + 2 * table.index(blockedBits)];
+}
+
+/**
+ * @brief isForbidden Объединяет формы 4 линий через клетку.
+ *
+ * Пятёрка разрешена всегда; длинный ряд и две четвёрки запрещены; две тройки запрещены,
+ * если обе открыты (openThree).
+ */
+template <int N>
+bool RenjuRules::isForbidden(const BasicGameLogic<N> &game, int row, int col) {
+    int cell = row * N + col;
+    uint16_t shapes[4];
+    int shapeBits = 0, fourCount = 0, threeCount = 0;
+    for (int d = 0; d < 4; d++) {
+        shapes[d] = game.renjuShape(d, cell);
+        shapeBits |= shapes[d];
+        fourCount += fours(shapes[d]);
+        threeCount += isThree(shapes[d]);
+    }
+    if (shapeBits & FiveBit)
+        return false;
+    if ((shapeBits & OverlineBit) || fourCount >= 2)
+        return true;
+    if (threeCount < 2)
+        return false;
+
+    int openThrees = 0;
+    for (int d = 0; d < 4 && openThrees < 2; d++) {
+        if (isThree(shapes[d]) && openThree(game, row, col, d, shapes[d]))
+            openThrees++;
+    }
+    return openThrees >= 2;
+}
+
+/**
+ * @brief openThree Проверяет клетки, достраивающие тройку до открытой четвёрки.
+ *
+ * Камень в (row, col) лежит только на линии dir клетки q, поэтому форма линии dir
+ * для q считается заново с этим камнем, а формы трёх других линий берутся из кэша.
+ */
+template <int N>
+bool RenjuRules::openThree(const BasicGameLogic<N> &game, int row, int col, int dir, uint16_t shape) {
+    using Game = BasicGameLogic<N>;
+    GameLogicBase::Player black = game.getBlackPlayer();
+    GameLogicBase::Player white = (black == GameLogicBase::Human) ? GameLogicBase::AI : GameLogicBase::Human;
+    int index = Game::lineIndex(dir, row, col);
+    int pos = Game::linePosition(dir, row, col);
+    int length = Game::lineLength(dir, index);
+    uint32_t own = game.lineMask(black, dir, index) | (1u << pos);
+    uint32_t opp = game.lineMask(white, dir, index);
+
+    int cells = (shape & ThreeMask) >> ThreeShift;
+    for (int offset = -(WINDOW - 1); offset <= WINDOW - 1; offset++) {
+        if (!((cells >> (offset + WINDOW - 1)) & 1))
+            continue;
+        uint16_t line = lineShape(own, opp, length, pos + offset);
+        int shapeBits = line, fourCount = fours(line), threeCount = 0;
+        int next = (row + offset * ROW_STEP[dir]) * N + col + offset * COL_STEP[dir];
+        for (int d = 0; d < 4; d++) {
+            if (d == dir)
+                continue;
+            uint16_t other = game.renjuShape(d, next);
+            shapeBits |= other;
+            fourCount += fours(other);
+            threeCount += isThree(other);
+        }
+        bool forbidden = !(shapeBits & FiveBit) && ((shapeBits & OverlineBit) || fourCount >= 2 || threeCount >= 2);
+        if (!forbidden)
+            return true;
+    }
+    return false;
+}
+
+template bool RenjuRules::isForbidden<15>(const BasicGameLogic<15> &, int, int);
+template bool RenjuRules::isForbidden<19>(const BasicGameLogic<19> &, int, int);
+template bool RenjuRules::isForbidden<20>(const BasicGameLogic<20> &, int, int);
@@ -0,0 +1,74 @@
+#include "../include/search-stats.h"
+#include <algorithm>
+#include <cstdio>
+
+void SearchStats::clear() {
+    *this = SearchStats();
+}
+
+void SearchStats::addIteration(long long timeMs) {
+    if (iterations < MAX_ITERATIONS)
+        iterationTimeMs[iterations++] = timeMs;
+}
+
+void SearchStats::setPv(const std::pair<int, int> *moves, int count) {
+    pvLength = std::min(count, int(MAX_PV_LENGTH));
+    std::copy(moves, moves + pvLength, pv);
+}
+
+void SearchStats::merge(const SearchStats &other) {
+    nodes += other.nodes;
+    evaluations += other.evaluations;
+    ttProbes += other.ttProbes;
+    ttHits += other.ttHits;
+    researches += other.researches;
+    reductions += other.reductions;
+    reductionResearches += other.reductionResearches;
+    futilityPrunes += other.futilityPrunes;
+    nullMoveCutoffs += other.nullMoveCutoffs;
+    quiescenceNodes += other.quiescenceNodes;
+    for (int i = 0; i < CUTOFF_BUCKETS; i++)
+        cutoffsByIndex[i] += other.cutoffsByIndex[i];
+    maxPly = std::max(maxPly, other.maxPly);
+}
+
+long long SearchStats::betaCutoffs() const {
+    long long total = 0;
+    for (int i = 0; i < CUTOFF_BUCKETS; i++)
+        total += cutoffsByIndex[i];
+    return total;
+}
+
+double SearchStats::ttHitRate() const {
+    return ttProbes > 0 ? double(ttHits) / double(ttProbes) : 0.0;
+}
+
+double SearchStats::firstMoveCutoffRate() const {
+    long long total = betaCutoffs();
+    return total > 0 ? double(cutoffsByIndex[0]) / double(total) : 0.0;
+}
+
+std::string SearchStats::summary() const {
+    std::string text = "узлов " + std::to_string(nodes);
+    if (enabled) {
+        char buffer[128];
+        std::snprintf(buffer, sizeof(buffer), ", оценок %lld, TT %.0f%%, отсечений на 1-м ходе %.0f%%, глубина до %d",
+                      evaluations, ttHitRate() * 100.0, firstMoveCutoffRate() * 100.0, maxPly);
+        text += buffer;
+        if (reductions > 0 || futilityPrunes > 0 || nullMoveCutoffs > 0) {
+            std::snprintf(buffer, sizeof(buffer), ", LMR %lld (повторно %lld), futility %lld, нулевой ход %lld",
+                          reductions, reductionResearches, futilityPrunes, nullMoveCutoffs);
+            text += buffer;
+        }
+        if (quiescenceNodes > 0)
+            text += ", продление угроз " + std::to_string(quiescenceNodes);
+    }
+    if (iterations > 0)
+        text += ", " + std::to_string(iterationTimeMs[iterations - 1]) + " мс";
+    if (pvLength > 0) {
+        text += ", вариант";
+        for (int i = 0; i < pvLength; i++)
+            text += " " + std::to_string(pv[i].first) + "," + std::to_string(pv[i].second);
+    }
+    return text;
+}
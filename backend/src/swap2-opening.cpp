@@ -0,0 +1,149 @@
+#include "../include/swap2-opening.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+// Ставит камни по порядку ходов, начиная с чёрных; чёрными играет black.
+template <int N>
+bool placeStones(BasicGameLogic<N> &game, const std::vector<std::pair<int, int>> &stones,
+                 GameLogicBase::Player black) {
+    GameLogicBase::Player white = (black == GameLogicBase::Human) ? GameLogicBase::AI : GameLogicBase::Human;
+    game.reset();
+    game.setRules(game.getRules(), black);
+    for (std::size_t i = 0; i < stones.size(); i++) {
+        if (!game.playMove(stones[i].first, stones[i].second, (i % 2 == 0) ? black : white))
+            return false;
+    }
+    return true;
+}
+
+// Лимит одного из count поисков, на которые делится решение.
+SearchLimits share(const SearchLimits &limits, int count) {
+    SearchLimits part = limits;
+    part.useBook = false;
+    if (limits.timeLimitMs > 0)
+        part.timeLimitMs = std::max(1, limits.timeLimitMs / count);
+    return part;
+}
+
+} // namespace
+
+/**
+ * @brief decide Позиции строятся так, что чёрными играет Human, а белыми – AI,
+ * поэтому поиск за AI (maximizingPlayer) даёт оценку и ход белых.
+ */
+template <int N>
+Swap2Decision Swap2Opening::decide(BasicGameLogic<N> &game, BasicAlphaBetaAI<N> &ai,
+                                   const std::vector<std::pair<int, int>> &stones, const SearchLimits &limits) {
+    Swap2Decision decision;
+
+    if (stones.empty()) {
+        // Дебюты с точностью до симметрии: белый над центром или по диагонали от него.
+        const int center = N / 2;
+        const int whiteSteps[2][2] = {{-1, 0}, {-1, 1}};
+        std::vector<std::vector<std::pair<int, int>>> openings;
+        std::vector<uint64_t> keys;
+        for (const auto &step : whiteSteps) {
+            for (int dr = -2; dr <= 2; dr++) {
+                for (int dc = -2; dc <= 2; dc++) {
+                    std::vector<std::pair<int, int>> opening = {
+                        {center, center}, {center + step[0], center + step[1]}, {center + dr, center + dc}};
+                    if (!placeStones(game, opening, GameLogicBase::Human))
+                        continue;
+                    int symmetry;
+                    uint64_t key = game.canonicalHash(GameLogicBase::AI, symmetry);
+                    if (std::find(keys.begin(), keys.end(), key) != keys.end())
+                        continue;
+                    keys.push_back(key);
+                    openings.push_back(opening);
+                }
+            }
+        }
+        SearchLimits part = share(limits, int(openings.size()));
+        for (const auto &opening : openings) {
+            placeStones(game, opening, GameLogicBase::Human);
+            int score = ai.search(game, part, true).score;
+            if (decision.stones.empty() || std::abs(score) < std::abs(decision.score)) {
+                decision.stones = opening;
+                decision.score = score;
+            }
+        }
+        decision.action = Swap2Decision::PlaceOpening;
+        placeStones(game, decision.stones, GameLogicBase::AI);
+        return decision;
+    }
+
+    // Три камня: половина лимита на оценку, остальное – на выбор двух камней.
+    bool threeStones = stones.size() == 3;
+    placeStones(game, stones, GameLogicBase::Human);
+    SearchResult white = ai.search(game, share(limits, threeStones ? 2 : 1), true);
+    decision.score = white.score;
+    bool whiteBetter = white.move.first >= 0 && white.score >= (threeStones ? BALANCE_MARGIN : 0);
+    bool blackBetter = white.move.first < 0 || white.score < (threeStones ? -BALANCE_MARGIN : 0);
+
+    if (whiteBetter) {
+        decision.action = Swap2Decision::PlayWhite;
+        decision.stones.assign(1, white.move);
+        game.playMove(white.move.first, white.move.second, GameLogicBase::AI);
+        return decision;
+    }
+    if (blackBetter) {
+        decision.action = Swap2Decision::TakeBlack;
+        placeStones(game, stones, GameLogicBase::AI);
+        return decision;
+    }
+
+    // Позиция равная: ставим лучший белый камень и чёрный, после которого она остаётся равной.
+    // Кандидаты – самые равные по статической оценке, из них выбирает поиск.
+    game.playMove(white.move.first, white.move.second, GameLogicBase::AI);
+    std::vector<std::pair<int, std::pair<int, int>>> candidates;
+    for (auto move : game.getCandidateMoves()) {
+        if (game.isForbidden(move.first, move.second, GameLogicBase::Human))
+            continue;
+        game.makeMove(move.first, move.second, GameLogicBase::Human);
+        if (game.checkWinner() == GameLogicBase::None)
+            candidates.emplace_back(std::abs(game.evaluation()), move);
+        game.undoMove(move.first, move.second);
+    }
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const std::pair<int, std::pair<int, int>> &a,
+                        const std::pair<int, std::pair<int, int>> &b) { return a.first < b.first; });
+    if (candidates.size() > std::size_t(BALANCE_CANDIDATES))
+        candidates.resize(BALANCE_CANDIDATES);
+
+    std::vector<std::pair<int, int>> position = stones;
+    position.push_back(white.move);
+    std::pair<int, int> black(-1, -1);
+    SearchLimits part = share(limits, 2 * int(candidates.size()));
+    for (const auto &candidate : candidates) {
+        game.playMove(candidate.second.first, candidate.second.second, GameLogicBase::Human);
+        int score = ai.search(game, part, true).score;
+        game.takeBack();
+        if (black.first < 0 || std::abs(score) < std::abs(decision.score)) {
+            black = candidate.second;
+            decision.score = score;
+        }
+    }
+    if (black.first < 0) {
+        // Поставить чёрный камень некуда: остаёмся белыми.
+        decision.action = Swap2Decision::PlayWhite;
+        decision.stones.assign(1, white.move);
+        return decision;
+    }
+    decision.action = Swap2Decision::PlaceTwo;
+    decision.stones = {white.move, black};
+    position.push_back(black);
+    // Цвет теперь выбирает соперник. Белые ходят следующими, и если соперник выбирает белых и
+    // ходит, движок играет чёрными – так позиция и строится. Если соперник берёт чёрные, ход
+    // за движком, и цвета переназначает вызывающий код (piskvork: BOARD и updateBlackPlayer).
+    placeStones(game, position, GameLogicBase::AI);
+    return decision;
+}
+
+template Swap2Decision Swap2Opening::decide<15>(BasicGameLogic<15> &, BasicAlphaBetaAI<15> &,
+                                                const std::vector<std::pair<int, int>> &, const SearchLimits &);
+template Swap2Decision Swap2Opening::decide<19>(BasicGameLogic<19> &, BasicAlphaBetaAI<19> &,
+                                                const std::vector<std::pair<int, int>> &, const SearchLimits &);
+template Swap2Decision Swap2Opening::decide<20>(BasicGameLogic<20> &, BasicAlphaBetaAI<20> &,
+                                                const std::vector<std::pair<int, int>> &, const SearchLimits &);
@@ -0,0 +1,290 @@
+#include "../include/threat-solver.h"
+#include "../include/pattern-evaluator.h"
+#include <algorithm>
+
+template <int N>
+ThreatResult ThreatSolver::solve(BasicGameLogic<N> &game, GameLogicBase::Player attackingPlayer, Mode searchMode,
+                                 const ThreatLimits &searchLimits) {
+    attacker = attackingPlayer;
+    defender = (attacker == GameLogicBase::AI) ? GameLogicBase::Human : GameLogicBase::AI;
+    mode = searchMode;
+    limits = searchLimits;
+    nodes = 0;
+    stopped = stopRequested.load(std::memory_order_relaxed);
+    startTime = std::chrono::steady_clock::now();
+    // Записи прошлых поисков отличаются номером поиска, поэтому таблицу не нужно очищать.
+    if (failed.empty())
+        failed.resize(std::size_t(1) << FAILED_TABLE_BITS);
+    if (seen.size() < std::size_t(N * N))
+        seen.resize(N * N);
+    generation++;
+    // Списки уровней сразу получают наибольшую ёмкость, чтобы не расти во время перебора.
+    if (frames.size() < std::size_t(2 * limits.maxDepth + 2))
+        frames.resize(2 * limits.maxDepth + 2);
+    for (Frame &frame : frames) {
+        frame.fives.reserve(N * N);
+        frame.opponentFives.reserve(N * N);
+        frame.moves.reserve(N * N);
+        frame.line.reserve(frames.size());
+    }
+
+    ThreatResult result;
+    // Углубляемся постепенно, чтобы найти самую короткую выигрышную серию.
+    for (int depth = 1; depth <= limits.maxDepth && !stopped; depth++) {
+        if (attack(game, depth, 0)) {
+            result.found = true;
+            break;
+        }
+    }
+    result.nodes = nodes;
+    result.aborted = stopped;
+    return result;
+}
+
+/**
+ * @brief attack Перебирает угрозы атакующего.
+ *
+ * Сначала проверяется немедленная пятёрка. Если у защищающегося есть четвёрка,
+ * атакующий обязан её закрыть (а две четвёрки закрыть нельзя). Иначе перебираются
+ * ходы, создающие четвёрку, а в режиме VCT – и открытую тройку; сильные угрозы первыми.
+ * Запрещённые ходы чёрных в рэндзю не рассматриваются.
+ */
+template <int N>
+bool ThreatSolver::attack(BasicGameLogic<N> &game, int depth, int ply) {
+    if (checkStop())
+        return false;
+
+    Frame &frame = frames[ply];
+    fiveCells(game, attacker, frame.fives);
+    if (!frame.fives.empty()) {
+        frame.line.assign(1, frame.fives[0]);
+        return true;
+    }
+    if (depth == 0)
+        return false;
+
+    // Позиции, симметричные уже проверенной, дают тот же результат.
+    int symmetry;
+    uint64_t key = game.canonicalHash(attacker, symmetry);
+    if (isFailed(key, depth))
+        return false;
+
+    // Против четвёрки защищающегося единственный кандидат – её клетка пятёрки.
+    fiveCells(game, defender, frame.opponentFives);
+    if (frame.opponentFives.size() >= 2)
+        return false;
+    bool forced = frame.opponentFives.size() == 1;
+    int candidateCount = forced ? 1 : game.candidateCount();
+
+    // Угрозы упорядочены по убыванию силы; равные остаются в порядке фронтира.
+    PatternEvaluator::Threat minThreat = (mode == VCF) ? PatternEvaluator::Four : PatternEvaluator::OpenThree;
+    auto &threats = frame.moves;
+    threats.clear();
+    for (int i = 0; i < candidateCount; i++) {
+        int cell = forced ? frame.opponentFives[0].first * N + frame.opponentFives[0].second : game.candidateAt(i);
+        int row = cell / N, col = cell % N;
+        if (game.isForbidden(row, col, attacker))
+            continue;
+        PatternEvaluator::Threat threat = PatternEvaluator::moveThreat(game, row, col, attacker);
+        if (threat < minThreat)
+            continue;
+        auto position = std::upper_bound(threats.begin(), threats.end(), int(threat),
+                                         [](int value, const std::pair<int, std::pair<int, int>> &entry) {
+                                             return value > entry.first;
+                                         });
+        threats.insert(position, std::make_pair(int(threat), std::make_pair(row, col)));
+    }
+
+    for (std::size_t i = 0; i < threats.size(); i++) {
+        std::pair<int, int> move = threats[i].second;
+        game.makeMove(move.first, move.second, attacker);
+        bool win = defend(game, move, depth, ply + 1);
+        game.undoMove(move.first, move.second);
+        if (stopped)
+            return false;
+        if (win) {
+            const auto &continuation = frames[ply + 1].line;
+            frame.line.assign(1, move);
+            frame.line.insert(frame.line.end(), continuation.begin(), continuation.end());
+            return true;
+        }
+    }
+
+    storeFailed(key, depth);
+    return false;
+}
+
+/**
+ * @brief defend Перебирает защиты от угрозы атакующего.
+ *
+ * Против четвёрки защита одна – клетка пятёрки; против двух клеток пятёрки
+ * (открытая или двойная четвёрка) защиты нет. Против открытой тройки защитами
+ * считаются клетки её линий (до четырёх клеток от хода атакующего threat),
+ * где атакующий получил бы четвёрку, и все контратакующие четвёрки защищающегося –
+ * такая клетка не дальше двух клеток по линии от его камня. Клетки берутся с доски,
+ * а не из фронтира: при радиусе фронтира 1 в нём нет, например, крайних клеток
+ * окна __XXX__, через клетку от тройки. Атака успешна, только если выигрывает после каждой защиты;
+ * в выигрышную серию записывается вариант первой защиты. Чёрные в рэндзю не могут
+ * защищаться запрещённым ходом, поэтому четвёрка с запрещённой для них клеткой пятёрки выигрывает.
+ */
+template <int N>
+bool ThreatSolver::defend(BasicGameLogic<N> &game, std::pair<int, int> threat, int depth, int ply) {
+    if (checkStop())
+        return false;
+
+    Frame &frame = frames[ply];
+    const auto &wins = frame.fives;
+    fiveCells(game, attacker, frame.fives);
+    if (wins.size() >= 2) {
+        frame.line.assign(1, wins[0]);
+        frame.line.push_back(wins[1]);
+        return true;
+    }
+
+    auto &defences = frame.moves;
+    defences.clear();
+    if (wins.size() == 1) {
+        if (game.isForbidden(wins[0].first, wins[0].second, defender)) {
+            frame.line.assign(1, wins[0]);
+            return true;
+        }
+        defences.emplace_back(0, wins[0]);
+    } else {
+        if (++seenStamp == 0) {
+            std::fill(seen.begin(), seen.end(), 0);
+            seenStamp = 1;
+        }
+        lineDefences(game, threat.first, threat.second, 4, attacker, defences);
+        for (int row = 0; row < N; row++)
+            for (int col = 0; col < N; col++)
+                if (game.board[row][col] == defender)
+                    lineDefences(game, row, col, 2, defender, defences);
+    }
+
+    for (std::size_t i = 0; i < defences.size(); i++) {
+        std::pair<int, int> move = defences[i].second;
+        game.makeMove(move.first, move.second, defender);
+        bool win = attack(game, depth - 1, ply + 1);
+        game.undoMove(move.first, move.second);
+        if (!win)
+            return false;
+        if (i == 0) {
+            const auto &continuation = frames[ply + 1].line;
+            frame.line.assign(1, move);
+            frame.line.insert(frame.line.end(), continuation.begin(), continuation.end());
+        }
+    }
+    return !defences.empty();
+}
+
+// На линии есть окно из пяти клеток через позицию pos без камней other и с тремя камнями own:
+// только тогда ход own в pos может дать на этой линии четвёрку.
+static bool fourWindow(uint32_t own, uint32_t other, int length, int pos) {
+    for (int start = std::max(0, pos - 4); start <= pos && start + 5 <= length; start++) {
+        uint32_t window = 0x1Fu << start;
+        if (other & window)
+            continue;
+        int stones = 0;
+        for (uint32_t w = own & window; w; w &= w - 1)
+            stones++;
+        if (stones >= 3)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief lineDefences Просматривает пустые клетки на линиях через (row, col).
+ *
+ * Около хода атакующего проверяются все клетки окон его линий. Около камней защищающегося
+ * ищутся только его четвёрки: такая четвёрка лежит на одной линии с его камнем не дальше
+ * двух клеток от хода, поэтому проверка угроз делается лишь для клеток, где на линии,
+ * по которой до них дошли, есть окно с тремя камнями защищающегося.
+ */
+template <int N>
+void ThreatSolver::lineDefences(const BasicGameLogic<N> &game, int row, int col, int radius,
+                                GameLogicBase::Player player,
+                                std::vector<std::pair<int, std::pair<int, int>>> &defences) {
+    using Game = BasicGameLogic<N>;
+    GameLogicBase::Player other = (player == attacker) ? defender : attacker;
+    for (int dir = 0; dir < 4; dir++) {
+        int index = Game::lineIndex(dir, row, col);
+        int pos = Game::linePosition(dir, row, col);
+        int length = Game::lineLength(dir, index);
+        uint32_t own = game.lineMask(player, dir, index);
+        uint32_t opp = game.lineMask(other, dir, index);
+        for (int p = std::max(0, pos - radius); p <= std::min(length - 1, pos + radius); p++) {
+            int cell = Game::lineCell(dir, index, p);
+            if (((own | opp) >> p & 1) || seen[cell] == seenStamp)
+                continue;
+            if (player == defender && !fourWindow(own, opp, length, p))
+                continue;
+            seen[cell] = seenStamp;
+            int r = cell / N, c = cell % N;
+            if (game.isForbidden(r, c, defender))
+                continue;
+            if (PatternEvaluator::moveThreat(game, r, c, attacker) >= PatternEvaluator::Four ||
+                PatternEvaluator::moveThreat(game, r, c, defender) >= PatternEvaluator::Four)
+                defences.emplace_back(0, std::make_pair(r, c));
+        }
+    }
+}
+
+template <int N>
+void ThreatSolver::fiveCells(const BasicGameLogic<N> &game, GameLogicBase::Player player,
+                             std::vector<std::pair<int, int>> &cells) const {
+    cells.clear();
+    for (int i = 0; i < game.candidateCount(); i++) {
+        int cell = game.candidateAt(i);
+        int row = cell / N;
+        int col = cell % N;
+        if (game.checkWin(row, col, player))
+            cells.emplace_back(row, col);
+    }
+}
+
+bool ThreatSolver::isFailed(uint64_t key, int depth) const {
+    const FailedEntry &entry = failed[key & ((uint64_t(1) << FAILED_TABLE_BITS) - 1)];
+    return entry.generation == generation && entry.key == key && entry.depth >= depth;
+}
+
+/**
+ * @brief storeFailed Записывает проигрыш атаки в таблицу.
+ *
+ * Таблица – только кэш: запись другой позиции с тем же индексом замещается,
+ * и потеря записи стоит лишь повторной проверки позиции.
+ */
+void ThreatSolver::storeFailed(uint64_t key, int depth) {
+    FailedEntry &entry = failed[key & ((uint64_t(1) << FAILED_TABLE_BITS) - 1)];
+    if (entry.generation == generation && entry.key == key && entry.depth >= depth)
+        return;
+    entry.key = key;
+    entry.generation = generation;
+    entry.depth = depth;
+}
+
+/**
+ * @brief checkStop Учитывает очередной узел и проверяет лимиты.
+ *
+ * Часы и внешний запрос опрашиваются раз в 256 узлов.
+ */
+bool ThreatSolver::checkStop() {
+    if (stopped)
+        return true;
+    nodes++;
+    if (limits.maxNodes > 0 && nodes >= limits.maxNodes)
+        stopped = true;
+    else if ((nodes & 255) == 0) {
+        if (stopRequested.load(std::memory_order_relaxed))
+            stopped = true;
+        else if (limits.timeLimitMs > 0 &&
+                 std::chrono::duration_cast<std::chrono::milliseconds>(
+                     std::chrono::steady_clock::now() - startTime).count() >= limits.timeLimitMs)
+            stopped = true;
+    }
+    return stopped;
+}
+
+template ThreatResult ThreatSolver::solve<15>(BasicGameLogic<15> &, GameLogicBase::Player, Mode, const ThreatLimits &);
+template ThreatResult ThreatSolver::solve<19>(BasicGameLogic<19> &, GameLogicBase::Player, Mode, const ThreatLimits &);
+template ThreatResult ThreatSolver::solve<20>(BasicGameLogic<20> &, GameLogicBase::Player, Mode, const ThreatLimits &);
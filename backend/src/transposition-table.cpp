@@ -0,0 +1,88 @@
+#include "../include/transposition-table.h"
+
+/*
+ * Формат упакованных данных записи (64 бита):
+ *   биты  0..31 – оценка (int32)
+ *   биты 32..39 – глубина (int8)
+ *   биты 40..41 – тип границы
+ *   биты 42..47 – номер поиска (generation)
+ *   биты 48..63 – лучший ход (0xFFFF – хода нет)
+ */
+
+TranspositionTable::TranspositionTable(std::size_t sizeMb) {
+    resize(sizeMb);
+}
+
+// Выделяет максимальное число записей (степень двойки), помещающееся в sizeMb мегабайт.
+void TranspositionTable::resize(std::size_t sizeMb) {
+    std::size_t bytes = (sizeMb > 0 ? sizeMb : 1) * 1024 * 1024;
+    std::size_t count = 1;
+    while (count * 2 * sizeof(Slot) <= bytes)
+        count *= 2;
+    slots.reset(new Slot[count]);
+    mask = count - 1;
+    clear();
+}
+
+void TranspositionTable::clear() {
+    for (std::size_t i = 0; i <= mask; i++) {
+        slots[i].check.store(0, std::memory_order_relaxed);
+        slots[i].data.store(0, std::memory_order_relaxed);
+    }
+    generation = 0;
+}
+
+void TranspositionTable::newSearch() {
+    generation = (generation + 1) & 0x3F;
+}
+
+uint64_t TranspositionTable::pack(int score, int depth, Bound bound, int move, uint8_t generation) {
+    uint64_t data = static_cast<uint32_t>(score);
+    data |= static_cast<uint64_t>(static_cast<uint8_t>(depth)) << 32;
+    data |= static_cast<uint64_t>(bound & 0x3) << 40;
+    data |= static_cast<uint64_t>(generation & 0x3F) << 42;
+    data |= static_cast<uint64_t>(move < 0 ? 0xFFFF : (move & 0xFFFF)) << 48;
+    return data;
+}
+
+// Запись считается найденной, если check ^ data совпадает с ключом позиции.
+bool TranspositionTable::probe(uint64_t key, Entry &entry) const {
+    const Slot &slot = slots[key & mask];
+    uint64_t data = slot.data.load(std::memory_order_relaxed);
+    uint64_t check = slot.check.load(std::memory_order_relaxed);
+    if ((check ^ data) != key)
+        return false;
+    Bound bound = static_cast<Bound>((data >> 40) & 0x3);
+    if (bound == NoBound)
+        return false;
+    entry.score = static_cast<int32_t>(static_cast<uint32_t>(data));
+    entry.depth = static_cast<int8_t>(static_cast<uint8_t>(data >> 32));
+    entry.bound = bound;
+    uint16_t move = static_cast<uint16_t>(data >> 48);
+    entry.move = (move == 0xFFFF) ? -1 : move;
+    return true;
+}
+
+// Замещение: запись другой позиции из текущего поиска вытесняется только более глубоким результатом,
+// записи прошлых поисков и записи той же позиции с меньшей глубиной заменяются всегда.
+void TranspositionTable::store(uint64_t key, int score, int depth, Bound bound, int move) {
+    Slot &slot = slots[key & mask];
+    uint64_t oldData = slot.data.load(std::memory_order_relaxed);
+    uint64_t oldKey = slot.check.load(std::memory_order_relaxed) ^ oldData;
+    Bound oldBound = static_cast<Bound>((oldData >> 40) & 0x3);
+    if (oldBound != NoBound) {
+        int oldDepth = static_cast<int8_t>(static_cast<uint8_t>(oldData >> 32));
+        uint8_t oldGeneration = (oldData >> 42) & 0x3F;
+        bool samePosition = oldKey == key;
+        if (oldGeneration == generation && depth < oldDepth && (!samePosition || bound != Exact))
+            return;
+        // Лучший ход прошлой записи той же позиции сохраняется, если новый не известен.
+        if (samePosition && move < 0) {
+            uint16_t oldMove = static_cast<uint16_t>(oldData >> 48);
+            move = (oldMove == 0xFFFF) ? -1 : oldMove;
+        }
+    }
+    uint64_t data = pack(score, depth, bound, move, generation);
+    slot.data.store(data, std::memory_order_relaxed);
+    slot.check.store(key ^ data, std::memory_order_relaxed);
+}
@@ -0,0 +1,301 @@
+/*
+ * gomoku-bench.cpp
+ *
+ * Бенчмарк движка: для набора фиксированных позиций (дебюты, миттельшпиль, тактика),
+ * записанных в текстовом файле, выполняется поиск на заданную глубину и выводятся
+ * число узлов, скорость (узлов в секунду), время, лучший ход и оценка.
+ *
+ * Машиночитаемый вывод (--format json или csv) предназначен для отслеживания
+ * регрессий производительности между коммитами.
+ *
+ * Использование: gomoku-bench [--positions FILE] [--depth N] [--threads N]
+ *                             [--format text|json|csv] [--mode alphabeta|pvs] [--no-threats]
+ *                             [--no-lmr] [--no-futility] [--no-null-move] [--quiescence N]
+ *
+ * Ключ --mode позволяет сравнить алгоритмы перебора (SearchMode) при одной и той же оценке,
+ * а ключи --no-lmr, --no-futility и --no-null-move – выключить по одному приёму выборочного поиска.
+ * Ключ --quiescence задаёт лимит узлов продления угроз от одного листа (0 – без продления).
+ *
+ * Бенчмарк заменяет глобальный operator new счётчиком и для каждой позиции выводит,
+ * сколько раз поиск выделял память в куче (allocs). Все позиции ищет один поисковик
+ * (таблица транспозиций очищается перед каждой), а перед замерами выполняется разогревочный
+ * поиск первой позиции: после него поиск не должен выделять память вовсе, и если хоть одна
+ * позиция потребовала выделений, бенчмарк завершается с ненулевым кодом.
+ */
+
+#include "gomoku-engine.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef GOMOKU_BENCH_POSITIONS
+#define GOMOKU_BENCH_POSITIONS "positions.txt"
+#endif
+
+// Число выделений памяти в куче за время работы программы (из всех потоков).
+static std::atomic<long long> allocationCount{0};
+
+void *operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void *memory = std::malloc(size > 0 ? size : 1))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+namespace {
+
+// Позиция бенчмарка: ходы (row, col), игроки чередуются начиная с Human.
+struct BenchPosition {
+    std::string name;
+    int depth = 0;
+    std::vector<std::pair<int, int>> moves;
+};
+
+// Результат поиска в одной позиции.
+struct BenchResult {
+    const BenchPosition *position = nullptr;
+    int depth = 0;
+    SearchResult search;
+    double timeMs = 0.0;
+    long long allocations = 0; // Выделений памяти в куче за время поиска.
+};
+
+/**
+ * @brief loadPositions Читает позиции из текстового файла (формат описан в bench/positions.txt).
+ * @return false, если файл не открылся или содержит ошибку; описание ошибки – в error.
+ */
+bool loadPositions(const std::string &path, std::vector<BenchPosition> &positions, std::string &error) {
+    std::ifstream file(path);
+    if (!file) {
+        error = "не удалось открыть " + path;
+        return false;
+    }
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        std::istringstream stream(line);
+        BenchPosition position;
+        if (!(stream >> position.name) || position.name[0] == '#')
+            continue;
+        if (!(stream >> position.depth) || position.depth <= 0) {
+            error = path + ":" + std::to_string(lineNumber) + ": ожидается глубина";
+            return false;
+        }
+        std::string move;
+        while (stream >> move) {
+            int row, col;
+            char comma;
+            std::istringstream moveStream(move);
+            if (!(moveStream >> row >> comma >> col) || comma != ',' || row < 0 || col < 0 ||
+                row >= GameLogic::BOARD_SIZE || col >= GameLogic::BOARD_SIZE) {
+                error = path + ":" + std::to_string(lineNumber) + ": неверный ход " + move;
+                return false;
+            }
+            position.moves.emplace_back(row, col);
+        }
+        positions.push_back(position);
+    }
+    return true;
+}
+
+std::string jsonEscape(const std::string &text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\')
+            escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+void printText(const std::vector<BenchResult> &results) {
+    std::printf("%-18s %5s %12s %12s %10s %8s %8s %8s\n", "position", "depth", "nodes", "nodes/s", "time_ms", "move",
+                "score", "allocs");
+    long long totalNodes = 0;
+    long long totalAllocations = 0;
+    double totalTime = 0.0;
+    for (const BenchResult &r : results) {
+        double nps = r.timeMs > 0 ? r.search.nodes * 1000.0 / r.timeMs : 0.0;
+        char move[16];
+        std::snprintf(move, sizeof(move), "%d,%d", r.search.move.first, r.search.move.second);
+        std::printf("%-18s %5d %12lld %12.0f %10.1f %8s %8d %8lld\n", r.position->name.c_str(), r.depth,
+                    r.search.nodes, nps, r.timeMs, move, r.search.score, r.allocations);
+        totalNodes += r.search.nodes;
+        totalAllocations += r.allocations;
+        totalTime += r.timeMs;
+    }
+    std::printf("\nИтого: %lld узлов за %.1f мс (%.0f узлов/с), выделений памяти %lld\n", totalNodes, totalTime,
+                totalTime > 0 ? totalNodes * 1000.0 / totalTime : 0.0, totalAllocations);
+}
+
+void printCsv(const std::vector<BenchResult> &results) {
+    std::printf("position,depth,nodes,nodes_per_second,time_ms,move_row,move_col,score,"
+                "evaluations,tt_hit_rate,first_cutoff_rate,max_ply,reductions,futility_prunes,null_move_cutoffs,"
+                "quiescence_nodes,allocations\n");
+    for (const BenchResult &r : results) {
+        double nps = r.timeMs > 0 ? r.search.nodes * 1000.0 / r.timeMs : 0.0;
+        const SearchStats &stats = r.search.stats;
+        std::printf("%s,%d,%lld,%.0f,%.3f,%d,%d,%d,%lld,%.4f,%.4f,%d,%lld,%lld,%lld,%lld,%lld\n",
+                    r.position->name.c_str(),
+                    r.depth, r.search.nodes, nps, r.timeMs, r.search.move.first, r.search.move.second,
+                    r.search.score, stats.evaluations, stats.ttHitRate(), stats.firstMoveCutoffRate(), stats.maxPly,
+                    stats.reductions, stats.futilityPrunes, stats.nullMoveCutoffs, stats.quiescenceNodes,
+                    r.allocations);
+    }
+}
+
+void printJson(const std::vector<BenchResult> &results, int threads, SearchMode mode) {
+    std::printf("{\n  \"threads\": %d,\n  \"mode\": \"%s\",\n  \"search_stats\": %s,\n  \"positions\": [\n",
+                threads, mode == SearchMode::Pvs ? "pvs" : "alphabeta", SearchStats::enabled ? "true" : "false");
+    for (std::size_t i = 0; i < results.size(); i++) {
+        const BenchResult &r = results[i];
+        const SearchStats &stats = r.search.stats;
+        double nps = r.timeMs > 0 ? r.search.nodes * 1000.0 / r.timeMs : 0.0;
+        std::string pv;
+        for (int m = 0; m < stats.pvLength; m++)
+            pv += (pv.empty() ? "[" : ", [") + std::to_string(stats.pv[m].first) + ", " +
+                  std::to_string(stats.pv[m].second) + "]";
+        std::printf("    {\"name\": \"%s\", \"depth\": %d, \"nodes\": %lld, \"nodes_per_second\": %.0f, "
+                    "\"time_ms\": %.3f, \"move\": [%d, %d], \"score\": %d, \"evaluations\": %lld, "
+                    "\"tt_hit_rate\": %.4f, \"first_cutoff_rate\": %.4f, \"max_ply\": %d, \"reductions\": %lld, "
+                    "\"futility_prunes\": %lld, \"null_move_cutoffs\": %lld, \"quiescence_nodes\": %lld, "
+                    "\"allocations\": %lld, \"pv\": [%s]}%s\n",
+                    jsonEscape(r.position->name).c_str(), r.depth, r.search.nodes, nps, r.timeMs,
+                    r.search.move.first, r.search.move.second, r.search.score, stats.evaluations,
+                    stats.ttHitRate(), stats.firstMoveCutoffRate(), stats.maxPly, stats.reductions,
+                    stats.futilityPrunes, stats.nullMoveCutoffs, stats.quiescenceNodes, r.allocations, pv.c_str(),
+                    i + 1 < results.size() ? "," : "");
+    }
+    std::printf("  ]\n}\n");
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    std::string positionsPath = GOMOKU_BENCH_POSITIONS;
+    std::string format = "text";
+    int depthOverride = 0;
+    int threads = 1;
+    bool threats = true;
+    SearchLimits selective; // Включённые приёмы выборочного поиска.
+    SearchMode mode = SearchMode::Pvs;
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--positions") && i + 1 < argc)
+            positionsPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--depth") && i + 1 < argc)
+            depthOverride = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc)
+            threads = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--format") && i + 1 < argc)
+            format = argv[++i];
+        else if (!std::strcmp(argv[i], "--mode") && i + 1 < argc && !std::strcmp(argv[i + 1], "alphabeta")) {
+            mode = SearchMode::AlphaBeta;
+            i++;
+        } else if (!std::strcmp(argv[i], "--mode") && i + 1 < argc && !std::strcmp(argv[i + 1], "pvs")) {
+            mode = SearchMode::Pvs;
+            i++;
+        } else if (!std::strcmp(argv[i], "--no-threats"))
+            threats = false;
+        else if (!std::strcmp(argv[i], "--no-lmr"))
+            selective.lateMoveReductions = false;
+        else if (!std::strcmp(argv[i], "--no-futility"))
+            selective.futilityPruning = false;
+        else if (!std::strcmp(argv[i], "--no-null-move"))
+            selective.nullMovePruning = false;
+        else if (!std::strcmp(argv[i], "--quiescence") && i + 1 < argc)
+            selective.quiescenceNodeLimit = std::max(0, std::atoi(argv[++i]));
+        else {
+            std::fprintf(stderr,
+                         "Использование: %s [--positions FILE] [--depth N] [--threads N] "
+                         "[--format text|json|csv] [--mode alphabeta|pvs] [--no-threats] "
+                         "[--no-lmr] [--no-futility] [--no-null-move] [--quiescence N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (format != "text" && format != "json" && format != "csv") {
+        std::fprintf(stderr, "Неизвестный формат вывода: %s\n", format.c_str());
+        return 1;
+    }
+
+    std::vector<BenchPosition> positions;
+    std::string error;
+    if (!loadPositions(positionsPath, positions, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    // Один поисковик на все позиции: память поиска выделяется один раз, при разогреве.
+    AlphaBetaAI ai;
+    ai.setThreadCount(threads);
+    std::vector<BenchResult> results;
+    results.reserve(positions.size());
+    long long totalAllocations = 0;
+    for (std::size_t p = 0; p < positions.size(); p++) {
+        const BenchPosition &position = positions[p];
+        GameLogic game;
+        GameLogic::Player player = GameLogic::Human;
+        for (const auto &move : position.moves) {
+            if (!game.makeMove(move.first, move.second, player)) {
+                std::fprintf(stderr, "%s: ход %d,%d невозможен\n", position.name.c_str(), move.first, move.second);
+                return 1;
+            }
+            player = (player == GameLogic::Human) ? GameLogic::AI : GameLogic::Human;
+        }
+
+        SearchLimits limits;
+        limits.maxDepth = depthOverride > 0 ? depthOverride : position.depth;
+        limits.mode = mode;
+        limits.lateMoveReductions = selective.lateMoveReductions;
+        limits.futilityPruning = selective.futilityPruning;
+        limits.nullMovePruning = selective.nullMovePruning;
+        limits.quiescenceNodeLimit = selective.quiescenceNodeLimit;
+        if (!threats)
+            limits.threatNodeLimit = 0;
+
+        // Разогрев: первый поиск поисковика выделяет память решателю угроз.
+        if (p == 0)
+            ai.search(game, limits, player == GameLogic::AI);
+        // Таблица транспозиций очищается, чтобы предыдущие позиции не влияли на результат.
+        ai.clearHash();
+
+        BenchResult result;
+        result.position = &position;
+        result.depth = limits.maxDepth;
+        long long allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+        auto start = std::chrono::steady_clock::now();
+        result.search = ai.search(game, limits, player == GameLogic::AI);
+        result.timeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        result.allocations = allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+        totalAllocations += result.allocations;
+        results.push_back(result);
+    }
+
+    if (format == "json")
+        printJson(results, threads, mode);
+    else if (format == "csv")
+        printCsv(results);
+    else
+        printText(results);
+    if (totalAllocations > 0) {
+        std::fprintf(stderr, "Поиск выделял память в куче после разогрева: %lld раз\n", totalAllocations);
+        return 1;
+    }
+    return 0;
+}
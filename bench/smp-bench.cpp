@@ -0,0 +1,101 @@
+/*
+ * smp-bench.cpp
+ *
+ * Бенчмарк параллельного поиска (Lazy SMP).
+ * Для набора фиксированных позиций выполняется поиск на заданную глубину
+ * с разным числом потоков; выводятся время, число узлов и ускорение
+ * относительно одного потока (время до достижения глубины), а также доля
+ * бета-отсечений на первом ходе узла (cut1st) – мера качества упорядочивания ходов.
+ *
+ * Использование: gomoku-smp-bench [--depth N] [--threads 1,2,4,8,16]
+ */
+
+#include "gomoku-engine.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Тестовая позиция: последовательность ходов (row, col), игроки чередуются начиная с Human.
+struct BenchPosition {
+    const char *name;
+    std::vector<std::pair<int, int>> moves;
+};
+
+std::vector<BenchPosition> benchPositions() {
+    return {
+        {"opening",    {{7, 7}, {7, 8}, {8, 8}, {6, 6}}},
+        {"middlegame", {{7, 7}, {7, 8}, {8, 8}, {6, 6}, {8, 7}, {9, 7}, {6, 8}, {8, 6}, {5, 9}, {4, 10}}},
+        {"tactical",   {{7, 7}, {8, 8}, {7, 8}, {9, 9}, {7, 6}, {10, 10}}},
+        {"crowded",    {{7, 7}, {7, 8}, {8, 7}, {6, 7}, {8, 8}, {9, 9}, {8, 6}, {8, 5}, {6, 8},
+                        {5, 9}, {9, 7}, {10, 7}, {6, 6}, {5, 5}, {9, 8}, {10, 9}}},
+    };
+}
+
+std::vector<int> parseList(const char *text) {
+    std::vector<int> values;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ','))
+        values.push_back(std::atoi(item.c_str()));
+    return values;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    int depth = 5;
+    std::vector<int> threadCounts = {1, 2, 4, 8, 16};
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--depth") && i + 1 < argc)
+            depth = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc)
+            threadCounts = parseList(argv[++i]);
+        else {
+            std::fprintf(stderr, "Использование: %s [--depth N] [--threads 1,2,4,8,16]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<BenchPosition> positions = benchPositions();
+    std::printf("%-12s %8s %10s %12s %12s %8s %8s\n", "position", "threads", "time_ms", "nodes", "nodes/s", "speedup",
+                "cut1st");
+    std::vector<double> totalTime(threadCounts.size(), 0.0);
+    for (const BenchPosition &position : positions) {
+        double baseTime = 0.0;
+        for (std::size_t t = 0; t < threadCounts.size(); t++) {
+            GameLogic game;
+            GameLogic::Player player = GameLogic::Human;
+            for (const auto &move : position.moves) {
+                game.makeMove(move.first, move.second, player);
+                player = (player == GameLogic::Human) ? GameLogic::AI : GameLogic::Human;
+            }
+
+            AlphaBetaAI ai;
+            ai.setThreadCount(threadCounts[t]);
+            SearchLimits limits;
+            limits.maxDepth = depth;
+            limits.threatNodeLimit = 0; // измеряется только перебор, без поиска по угрозам
+            auto start = std::chrono::steady_clock::now();
+            SearchResult result = ai.search(game, limits, player == GameLogic::AI);
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            if (t == 0)
+                baseTime = ms;
+            totalTime[t] += ms;
+            double nps = ms > 0 ? result.nodes * 1000.0 / ms : 0.0;
+            std::printf("%-12s %8d %10.1f %12lld %12.0f %7.2fx %7.1f%%\n", position.name, threadCounts[t], ms,
+                        result.nodes, nps, ms > 0 ? baseTime / ms : 0.0, result.firstMoveCutoffRate() * 100.0);
+        }
+    }
+    std::printf("\nИтого (глубина %d):\n", depth);
+    for (std::size_t t = 0; t < threadCounts.size(); t++)
+        std::printf("  потоков %2d: %10.1f мс, ускорение %.2fx\n", threadCounts[t], totalTime[t],
+                    totalTime[t] > 0 ? totalTime[0] / totalTime[t] : 0.0);
+    return 0;
+}
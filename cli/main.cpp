@@ -0,0 +1,44 @@
+/*
+ * main.cpp (gomoku-cli)
+ *
+ * Точка входа консольного движка: читает команды протокола Piskvork из stdin
+ * и пишет ответы в stdout. Графическая подсистема не используется,
+ * поэтому запуск занимает миллисекунды и не требует дисплея.
+ *
+ * Использование: gomoku-cli [--threads N] [--book FILE]
+ */
+
+#include "piskvork-brain.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+int main(int argc, char *argv[])
+{
+    int threads = 1;
+    std::string bookPath;
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) {
+            threads = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--book") && i + 1 < argc) {
+            bookPath = argv[++i];
+        } else {
+            std::cerr << "Использование: " << argv[0] << " [--threads N] [--book FILE]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::ios::sync_with_stdio(false);
+    PiskvorkBrain brain(threads);
+    if (!bookPath.empty() && !brain.loadOpeningBook(bookPath)) {
+        std::cerr << "Не удалось открыть дебютную книгу " << bookPath << std::endl;
+        return 1;
+    }
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        if (!brain.handleCommand(line, std::cout))
+            break;
+    }
+    return 0;
+}
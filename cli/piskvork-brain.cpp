@@ -0,0 +1,277 @@
+#include "piskvork-brain.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <ostream>
+#include <sstream>
+
+namespace {
+
+// Запас времени на ответ менеджеру и накладные расходы процесса.
+const int TIME_MARGIN_MS = 50;
+
+std::string toUpper(std::string text) {
+    for (char &c : text)
+        c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    return text;
+}
+
+} // namespace
+
+PiskvorkBrain::PiskvorkBrain(int threads) : threadCount(threads) {
+    startSession(GameLogic::BOARD_SIZE);
+}
+
+bool PiskvorkBrain::startSession(int size) {
+    if (engine && engine->boardSize() == size) {
+        engine->reset();
+        engine->clearHash();
+        return true;
+    }
+    std::unique_ptr<EngineSession> session = EngineSession::create(size);
+    if (!session)
+        return false;
+    session->setRules(rules, GameLogic::Human);
+    session->setThreadCount(threadCount);
+    if (hashSizeMb > 0)
+        session->setHashSize(hashSizeMb);
+    session->setOpeningBook(openingBook);
+    engine = std::move(session);
+    return true;
+}
+
+bool PiskvorkBrain::loadOpeningBook(const std::string &path) {
+    auto book = std::make_shared<OpeningBook>();
+    if (!book->open(path))
+        return false;
+    openingBook = book;
+    engine->setOpeningBook(openingBook);
+    return true;
+}
+
+bool PiskvorkBrain::handleCommand(const std::string &rawLine, std::ostream &out) {
+    std::string line = rawLine;
+    while (!line.empty() && (line.back() == '\r' || line.back() == ' '))
+        line.pop_back();
+    if (line.empty())
+        return true;
+
+    if (readingBoard) {
+        handleBoardLine(line, out);
+        return true;
+    }
+    if (readingSwap2) {
+        handleSwap2Line(line, out);
+        return true;
+    }
+
+    std::istringstream stream(line);
+    std::string command;
+    stream >> command;
+    command = toUpper(command);
+    std::string args;
+    std::getline(stream, args);
+
+    if (command == "START") {
+        int size = std::atoi(args.c_str());
+        if (!startSession(size)) {
+            out << "ERROR unsupported board size " << size << std::endl;
+            return true;
+        }
+        started = true;
+        out << "OK" << std::endl;
+    } else if (command == "RESTART") {
+        engine->reset();
+        engine->clearHash();
+        started = true;
+        out << "OK" << std::endl;
+    } else if (command == "BEGIN") {
+        if (!started) {
+            out << "ERROR game not started" << std::endl;
+            return true;
+        }
+        playMove(out);
+    } else if (command == "TURN") {
+        int values[3];
+        if (!started || parseNumbers(args, values) < 2) {
+            out << "ERROR bad TURN command" << std::endl;
+            return true;
+        }
+        // x – столбец, y – строка.
+        if (!engine->makeMove(values[1], values[0], GameLogic::Human)) {
+            out << "ERROR invalid move " << values[0] << "," << values[1] << std::endl;
+            return true;
+        }
+        playMove(out);
+    } else if (command == "BOARD") {
+        if (!started) {
+            out << "ERROR game not started" << std::endl;
+            return true;
+        }
+        engine->reset();
+        readingBoard = true;
+    } else if (command == "SWAP2BOARD") {
+        if (!started) {
+            out << "ERROR game not started" << std::endl;
+            return true;
+        }
+        swap2Stones.clear();
+        readingSwap2 = true;
+    } else if (command == "TAKEBACK") {
+        int values[3];
+        if (parseNumbers(args, values) < 2) {
+            out << "ERROR bad TAKEBACK command" << std::endl;
+            return true;
+        }
+        engine->undoMove(values[1], values[0]);
+        out << "OK" << std::endl;
+    } else if (command == "INFO") {
+        std::istringstream info(args);
+        std::string key, value;
+        info >> key >> value;
+        handleInfo(key, value);
+    } else if (command == "ABOUT") {
+        out << "name=\"gomoku-qt\", version=\"0.1\", author=\"gomoku-qt\", country=\"RU\"" << std::endl;
+    } else if (command == "END") {
+        return false;
+    } else {
+        out << "UNKNOWN " << command << std::endl;
+    }
+    return true;
+}
+
+// Строки блока BOARD: "x,y,поле". По протоколу: "1 – own stone, 2 – opponent's stone,
+// 3 – only if continuous game is enabled, stone is part of winning line or is forbidden
+// according to renju rules". Значение 3 – отметка менеджера, а не владелец камня, поэтому
+// такие строки (как и другие значения) пропускаются.
+void PiskvorkBrain::handleBoardLine(const std::string &line, std::ostream &out) {
+    if (toUpper(line) == "DONE") {
+        readingBoard = false;
+        playMove(out);
+        return;
+    }
+    int values[3];
+    if (parseNumbers(line, values) < 3) {
+        out << "DEBUG ignored board line " << line << std::endl;
+        return;
+    }
+    if (values[2] != 1 && values[2] != 2) {
+        out << "DEBUG ignored board line " << line << std::endl;
+        return;
+    }
+    GameLogic::Player player = (values[2] == 1) ? GameLogic::AI : GameLogic::Human;
+    engine->makeMove(values[1], values[0], player);
+}
+
+// Строки блока SWAP2BOARD: "x,y" – камни по порядку ходов, начиная с чёрного.
+void PiskvorkBrain::handleSwap2Line(const std::string &line, std::ostream &out) {
+    if (toUpper(line) != "DONE") {
+        int values[3];
+        if (parseNumbers(line, values) < 2)
+            out << "DEBUG ignored swap2 line " << line << std::endl;
+        else
+            swap2Stones.emplace_back(values[1], values[0]);
+        return;
+    }
+    readingSwap2 = false;
+
+    // Камни должны помещаться на доску и не повторяться.
+    engine->reset();
+    bool valid = swap2Stones.size() == 0 || swap2Stones.size() == 3 || swap2Stones.size() == 5;
+    for (std::size_t i = 0; i < swap2Stones.size() && valid; i++)
+        valid = engine->makeMove(swap2Stones[i].first, swap2Stones[i].second, GameLogic::Human);
+    if (!valid) {
+        engine->reset();
+        out << "ERROR bad SWAP2BOARD position" << std::endl;
+        return;
+    }
+
+    SearchLimits limits;
+    limits.maxDepth = AlphaBetaAI::MAX_SEARCH_DEPTH;
+    limits.timeLimitMs = moveTimeBudgetMs();
+    Swap2Decision decision = engine->swap2(swap2Stones, limits);
+    out << "MESSAGE swap2 score " << decision.score << std::endl;
+    if (decision.action == Swap2Decision::TakeBlack) {
+        out << "SWAP" << std::endl;
+        return;
+    }
+    for (std::size_t i = 0; i < decision.stones.size(); i++)
+        out << (i > 0 ? " " : "") << decision.stones[i].second << "," << decision.stones[i].first;
+    out << std::endl;
+}
+
+void PiskvorkBrain::updateBlackPlayer() {
+    int own = 0, opponent = 0;
+    for (int row = 0; row < engine->boardSize(); row++) {
+        for (int col = 0; col < engine->boardSize(); col++) {
+            own += engine->cell(row, col) == GameLogic::AI;
+            opponent += engine->cell(row, col) == GameLogic::Human;
+        }
+    }
+    engine->setRules(rules, own == opponent ? GameLogic::AI : GameLogic::Human);
+}
+
+void PiskvorkBrain::handleInfo(const std::string &rawKey, const std::string &value) {
+    std::string key = rawKey;
+    for (char &c : key)
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    int number = std::atoi(value.c_str());
+    if (key == "timeout_turn")
+        timeoutTurnMs = number;
+    else if (key == "timeout_match")
+        timeoutMatchMs = number;
+    else if (key == "time_left")
+        timeLeftMs = number;
+    else if (key == "max_memory" && number > 0) {
+        // Под таблицу транспозиций отводится половина разрешённой памяти.
+        hashSizeMb = std::max<std::size_t>(1, static_cast<std::size_t>(number) / 2 / (1024 * 1024));
+        engine->setHashSize(hashSizeMb);
+    } else if (key == "rule") {
+        rules = (number & 4) ? GameLogic::Renju : (number & 1) ? GameLogic::Standard : GameLogic::Freestyle;
+        engine->setRules(rules, engine->blackPlayer());
+    }
+    // Остальные ключи (game_type, evaluate, folder) пока не используются.
+}
+
+// Лимит на ход: timeout_turn (0 – "как можно быстрее"), но не больше 1/10 оставшегося времени партии.
+int PiskvorkBrain::moveTimeBudgetMs() const {
+    int budget = timeoutTurnMs > 0 ? timeoutTurnMs : 100;
+    if (timeoutMatchMs > 0 && timeLeftMs >= 0)
+        budget = std::min(budget, timeLeftMs / 10);
+    return std::max(10, budget - TIME_MARGIN_MS);
+}
+
+void PiskvorkBrain::playMove(std::ostream &out) {
+    updateBlackPlayer();
+    SearchLimits limits;
+    limits.maxDepth = AlphaBetaAI::MAX_SEARCH_DEPTH;
+    limits.timeLimitMs = moveTimeBudgetMs();
+    SearchResult result = engine->search(limits, true);
+    if (result.move.first < 0) {
+        out << "ERROR no moves available" << std::endl;
+        return;
+    }
+    engine->makeMove(result.move.first, result.move.second, GameLogic::AI);
+    out << "MESSAGE depth " << result.depth << " score " << result.score << " nodes " << result.nodes;
+    if (SearchStats::enabled)
+        out << " cut1st " << int(result.firstMoveCutoffRate() * 100.0 + 0.5) << "%";
+    if (result.forcedLength > 0)
+        out << " forced win in " << (result.forcedLength + 1) / 2;
+    if (result.fromBook)
+        out << " book";
+    out << std::endl;
+    out << result.move.second << "," << result.move.first << std::endl;
+}
+
+int PiskvorkBrain::parseNumbers(const std::string &text, int values[3]) {
+    int count = 0;
+    std::string item;
+    std::istringstream stream(text);
+    while (count < 3 && std::getline(stream, item, ',')) {
+        std::size_t start = item.find_first_not_of(" \t");
+        if (start == std::string::npos)
+            break;
+        values[count++] = std::atoi(item.c_str() + start);
+    }
+    return count;
+}
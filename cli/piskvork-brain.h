@@ -0,0 +1,98 @@
+#pragma once
+/*
+ * piskvork-brain.h
+ *
+ * Заголовочный файл класса PiskvorkBrain – текстового протокола движка
+ * в стиле Gomocup/Piskvork поверх EngineSession (GameLogic и AlphaBetaAI нужного размера доски).
+ *
+ * Поддерживаемые команды менеджера турнира:
+ *   START n          – новая игра на доске n x n (15, 19 или 20), ответ OK или ERROR;
+ *   RESTART          – новая игра того же размера, ответ OK;
+ *   BEGIN            – движок ходит первым, ответ "x,y";
+ *   TURN x,y         – ход соперника, ответ – ход движка "x,y";
+ *   BOARD ... DONE   – позиция строками "x,y,кто" (1 – свой камень, 2 – соперника), затем ответ-ход;
+ *   TAKEBACK x,y     – снять камень, ответ OK;
+ *   SWAP2BOARD ... DONE – дебют swap2: камни строками "x,y" по порядку ходов (0, 3 или 5),
+ *                      ответ – три камня дебюта, "SWAP", один ход белыми или два камня (см. Swap2Opening);
+ *   INFO key value   – параметры (timeout_turn, timeout_match, time_left, max_memory, rule), без ответа;
+ *   ABOUT            – информация о движке;
+ *   END              – завершение работы.
+ *
+ * Координаты протокола: x – столбец, y – строка, нумерация с нуля.
+ * Камни движка на доске – GameLogic::AI, камни соперника – GameLogic::Human.
+ *
+ * INFO rule – битовая маска Gomocup: 1 – ровно пять, 4 – рэндзю, остальные биты не поддерживаются.
+ * Чёрными считается тот, кто ходит при равном числе камней, поэтому цвет определяется
+ * по позиции перед каждым поиском.
+ */
+
+#include "gomoku-engine.h"
+#include <cstddef>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+class PiskvorkBrain {
+public:
+    /**
+     * @brief PiskvorkBrain Создаёт движок протокола.
+     * @param threads Число потоков поиска.
+     */
+    explicit PiskvorkBrain(int threads = 1);
+
+    /**
+     * @brief handleCommand Обрабатывает одну строку от менеджера.
+     * @param line Строка команды (без перевода строки).
+     * @param out Поток для ответов.
+     * @return false, если получена команда END и работу нужно завершить.
+     */
+    bool handleCommand(const std::string &line, std::ostream &out);
+
+    /**
+     * @brief loadOpeningBook Подключает дебютную книгу (см. opening-book.h).
+     * @param path Путь к файлу книги.
+     * @return false, если файл не открылся или имеет неверный формат.
+     */
+    bool loadOpeningBook(const std::string &path);
+
+private:
+    // Ищет и делает ход движка, выводит его в формате "x,y".
+    void playMove(std::ostream &out);
+
+    // Обработка строки "x,y,кто" внутри блока BOARD.
+    void handleBoardLine(const std::string &line, std::ostream &out);
+
+    // Обработка строки "x,y" внутри блока SWAP2BOARD; после DONE выводит решение swap2.
+    void handleSwap2Line(const std::string &line, std::ostream &out);
+
+    // Назначает чёрными того, кто ходит при равном числе камней (ходит движок).
+    void updateBlackPlayer();
+
+    // Обработка команды INFO.
+    void handleInfo(const std::string &key, const std::string &value);
+
+    // Разбирает "x,y" (или "x,y,z"); возвращает число прочитанных чисел.
+    static int parseNumbers(const std::string &text, int values[3]);
+
+    // Бюджет времени на текущий ход в миллисекундах с учётом timeout_turn и time_left.
+    int moveTimeBudgetMs() const;
+
+    // Создаёт сеанс для доски size x size с текущими настройками поиска; false, если размер не поддерживается.
+    bool startSession(int size);
+
+    std::unique_ptr<EngineSession> engine; // Позиция и поиск хода для текущего размера доски.
+    int threadCount = 1;                   // Число потоков поиска.
+    std::size_t hashSizeMb = 0;            // Размер таблицы транспозиций (0 – по умолчанию).
+    std::shared_ptr<const OpeningBook> openingBook; // Дебютная книга (может отсутствовать).
+    bool started = false;    // Получена команда START.
+    bool readingBoard = false; // Идёт чтение блока BOARD ... DONE.
+    bool readingSwap2 = false; // Идёт чтение блока SWAP2BOARD ... DONE.
+    std::vector<std::pair<int, int>> swap2Stones; // Камни блока SWAP2BOARD (row, col) по порядку ходов.
+    GameLogic::Rules rules = GameLogic::Freestyle; // Правила (INFO rule).
+
+    int timeoutTurnMs = 5000;  // Лимит времени на ход (INFO timeout_turn).
+    int timeoutMatchMs = 0;    // Лимит времени на партию (INFO timeout_match, 0 – без ограничения).
+    int timeLeftMs = -1;       // Оставшееся время на партию (INFO time_left, -1 – неизвестно).
+};
@@ -4,11 +4,24 @@
  *
  * Заголовочный файл для класса GameBoardWidget,
  * который реализует игровое поле: отрисовку доски, обработку ходов игрока и ИИ,
- * сохранение/отмену ходов, работу подсказок и переход в меню.
+ * сохранение/отмену/возврат ходов, работу подсказок и переход в меню.
  *
  * В этой версии введена переменная currentTurn, которая определяет, кто делает следующий ход.
  * При режиме "Бот против Бота" мы используем два разных кода игроков (GameLogic::Human и GameLogic::AI),
  * чтобы различать цвета фигур.
+ *
+ * Поиск хода ИИ (и подсказки) выполняется в отдельном потоке через SearchJob.
+ * Задержка MOVE_DELAY_MS только выдерживает темп показа ходов: поиск начинается
+ * сразу, и ход показывается не раньше, чем через MOVE_DELAY_MS после начала поиска.
+ *
+ * Каждый ход, отмена и конец партии сразу дописываются в журнал партий games.gmk
+ * в каталоге данных приложения (GameRecorder), поэтому после сбоя партию можно
+ * загрузить из журнала. Кнопки "Сохранить игру" и "Загрузить игру" работают с файлами
+ * партий (.gmk) и текстовым экспортом (.txt), см. game-record.h.
+ *
+ * Размер доски выбирается в меню: позиция хранится в EngineSession нужного размера,
+ * а размер клетки на экране подбирается так, чтобы доска занимала одно и то же место.
+ * Партии каждого размера пишутся в свой журнал (games.gmk для 15x15, games-19.gmk и т.д.).
  */
 
 #include <QWidget>
@@ -17,9 +30,12 @@
 #include <QPushButton>
 #include <QLabel>
 #include <QTimer>
+#include <QElapsedTimer>
+#include <memory>
 #include <vector>
-#include "../../backend/include/game-logic.h"
-#include "../../backend/include/alpha-beta-ai.h"
+#include "../../backend/include/engine-session.h"
+#include "../../backend/include/game-record.h"
+#include "search-job.h"
 
 /**
  * @brief Класс BoardView наследуется от QGraphicsView и обрабатывает клики по игровому полю.
@@ -27,11 +43,16 @@
 class BoardView : public QGraphicsView {
     Q_OBJECT
 public:
-    explicit BoardView(QWidget* parent = nullptr);
+    /**
+     * @brief BoardView Поле из boardSize x boardSize клеток по cellSize пикселей.
+     */
+    BoardView(int boardSize, int cellSize, QWidget* parent = nullptr);
 protected:
     void mousePressEvent(QMouseEvent* event) override;
 signals:
     void cellClicked(int row, int col);
+private:
+    int cellSize; // Размер клетки в пикселях.
 };
 
 /**
@@ -44,9 +65,12 @@ public:
      * @brief Конструктор игрового поля.
      * @param playerVsBot true, если режим "Игрок против Бота", иначе "Бот против Бота".
      * @param difficulty Глубина поиска для алгоритма alpha-beta.
+     * @param boardSize Размер доски (см. EngineSession::supportedBoardSizes).
+     * @param rules Правила; чёрными играет тот, кто ходит первым (GameLogic::Human).
      * @param parent Родительский виджет.
      */
-    explicit GameBoardWidget(bool playerVsBot, int difficulty, QWidget* parent = nullptr);
+    GameBoardWidget(bool playerVsBot, int difficulty, int boardSize, GameLogicBase::Rules rules,
+                    QWidget* parent = nullptr);
 
 signals:
     /// Сигнал возврата в меню (сброс текущей игры).
@@ -56,44 +80,54 @@ private slots:
     void onCellClicked(int row, int col);
     void onReturnToMenu();
     void onUndo();
+    void onRedo();
     void onHint();
     void onSaveGame();
     void onLoadGame();
     void onBotMove();
+    void onBotMoveReady();
+    void onSearchFinished(int row, int col);
+    void onSearchProgress(int depth, qint64 nodes, const QString& stats);
 
 private:
     void setupUI();
     void drawBoard();
     void updateBoard();
-    void addMoveToHistory();
     bool checkGameOver();
+    void playMove(int row, int col, GameLogic::Player player);
+    bool isBotThinking() const;
+    void cancelSearch();
 
     BoardView* boardView;         // Виджет для отображения игрового поля.
     QGraphicsScene* scene;        // Сцена для отрисовки элементов (сетка, фишки).
     QPushButton* btnReturn;       // Кнопка возврата в меню.
     QPushButton* btnUndo;         // Кнопка отмены последнего хода.
+    QPushButton* btnRedo;         // Кнопка возврата отменённого хода.
     QPushButton* btnHint;         // Кнопка подсказки от ИИ.
     QPushButton* btnSave;         // Кнопка сохранения игры.
     QPushButton* btnLoad;         // Кнопка загрузки сохраненной игры.
     QLabel* statusLabel;          // Метка для отображения текущего хода.
-    QTimer* botTimer;             // Таймер для автоматизированного хода ИИ.
+    QLabel* searchLabel;          // Метка с прогрессом поиска ИИ.
+    QTimer* botTimer;             // Таймер, выдерживающий темп показа ходов ИИ.
+
+    std::unique_ptr<EngineSession> game; // Логика игры: хранит состояние доски и методы для ходов.
+    SearchJob* searchJob;         // Поиск хода alpha-beta в отдельном потоке.
+    QElapsedTimer paceClock;      // Время с начала поиска текущего хода ИИ.
 
-    GameLogic game;               // Логика игры: хранит состояние доски и методы для ходов.
-    AlphaBetaAI ai;               // Объект для работы алгоритма alpha-beta.
+    // Назначение текущего поиска: ход бота или подсказка.
+    enum class PendingSearch { Nothing, BotMove, Hint };
+    PendingSearch pendingSearch = PendingSearch::Nothing;
+    std::pair<int, int> pendingMove; // Найденный ход бота, ожидающий показа.
     int botDepth;                 // Глубина поиска, определяющая уровень сложности.
     bool playerVsBot;             // Режим игры: true, если "Игрок против Бота".
 
     int currentTurn;              // Текущий игрок: будет равен GameLogic::Human или GameLogic::AI.
                                 // В режиме Bot vs Bot – это два разных бота с различными цветами.
 
-    // Структура для сохранения состояния игры (доска и чей ход следующий).
-    struct SavedState {
-        std::vector<std::vector<int>> board; // Текущее состояние доски.
-        int currentPlayer;                   // Тот, кто должен сделать следующий ход.
-    };
-    std::vector<SavedState> moveHistory; // История ходов для отмены.
-    SavedState lastSavedState;           // Сохранённое состояние игры.
-    bool hasSavedState = false;          // Флаг наличия сохранённого состояния.
+    // История ходов для отмены и возврата хранится в журнале партии game (EngineSession::moveLog).
+    GameRecorder recorder;        // Потоковая запись партии в журнал партий на диске.
 
-    const int cellSize = 30; // Размер клетки доски в пикселях.
+    const int cellSize;      // Размер клетки доски в пикселях (зависит от размера доски).
+    static const int BOARD_PIXELS = 450;   // Сторона доски в пикселях (для 15x15 – клетки по 30px).
+    static const int MOVE_DELAY_MS = 1000; // Минимальная пауза перед показом хода бота.
 };
@@ -22,8 +22,10 @@ private slots:
      * @brief startGame Запускает новую игру с заданными параметрами.
      * @param playerVsBot true, если выбран режим "Игрок против Бота", иначе "Бот против Бота".
      * @param difficulty Глубина поиска, определяющая уровень сложности.
+     * @param boardSize Размер доски.
+     * @param rules Правила (GameLogicBase::Rules).
      */
-    void startGame(bool playerVsBot, int difficulty);
+    void startGame(bool playerVsBot, int difficulty, int boardSize, int rules);
 
     /**
      * @brief returnToMenu Переход к главному меню (сброс текущей игры).
@@ -4,7 +4,7 @@
  *
  * Заголовок класса MenuWidget – стартового меню игры.
  * Здесь пользователь выбирает режим (Игрок против Бота или Бот против Бота)
- * и уровень сложности, задаваемый глубиной поиска.
+ * и уровень сложности, задаваемый глубиной поиска, а также размер доски и правила.
  */
 
 #include <QWidget>
@@ -25,8 +25,10 @@ signals:
      * @brief startGameRequested Сигнал, генерируемый при нажатии кнопки "Начать игру".
      * @param playerVsBot true, если выбран режим "Игрок против Бота", иначе "Бот против Бота".
      * @param difficulty Глубина поиска (2 – лёгкий, 3 – средний, 4 – трудный).
+     * @param boardSize Размер доски (см. EngineSession::supportedBoardSizes).
+     * @param rules Правила (GameLogicBase::Rules).
      */
-    void startGameRequested(bool playerVsBot, int difficulty);
+    void startGameRequested(bool playerVsBot, int difficulty, int boardSize, int rules);
 
 private slots:
     /// Обработчик нажатия кнопки "Начать игру"
@@ -34,6 +36,8 @@ private slots:
 
 private:
     QComboBox* difficultyCombo; // Выпадающий список для выбора уровня сложности.
+    QComboBox* boardSizeCombo;  // Выпадающий список для выбора размера доски.
+    QComboBox* rulesCombo;      // Выпадающий список для выбора правил.
     QRadioButton* rbPlayerVsBot; // Радиокнопка для режима "Игрок против Бота".
     QRadioButton* rbBotVsBot;    // Радиокнопка для режима "Бот против Бота".
     QPushButton* btnStart;       // Кнопка для запуска игры.
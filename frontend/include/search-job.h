@@ -0,0 +1,59 @@
+#pragma once
+/*
+ * search-job.h
+ *
+ * Заголовочный файл класса SearchJob, который выполняет поиск хода AlphaBetaAI
+ * в отдельном потоке, чтобы окно не "замерзало" на время поиска.
+ *
+ * Поиск ведётся в собственном сеансе EngineSession по копии журнала партии, поэтому
+ * игровое поле виджета можно безопасно читать и менять во время поиска. Результат и промежуточный прогресс
+ * доставляются в поток GUI сигналами. Отменённый поиск (кнопки "В меню",
+ * "Отменить ход") не присылает результата.
+ */
+
+#include <QObject>
+#include <QThread>
+#include <memory>
+#include "../../backend/include/engine-session.h"
+
+class SearchJob : public QObject {
+    Q_OBJECT
+public:
+    /**
+     * @brief SearchJob Создаёт поисковик для доски boardSize x boardSize.
+     */
+    explicit SearchJob(int boardSize, QObject* parent = nullptr);
+
+    // Деструктор прерывает поиск и дожидается завершения потока.
+    ~SearchJob() override;
+
+    /**
+     * @brief start Запускает поиск хода; предыдущий поиск при этом отменяется.
+     * @param game Позиция, для которой ищется ход (копируется её журнал партии).
+     * @param limits Ограничения поиска.
+     * @param maximizingPlayer Для какого игрока ищется ход (true – AI).
+     */
+    void start(const EngineSession& game, const SearchLimits& limits, bool maximizingPlayer);
+
+    /// Отменяет текущий поиск; сигнал finished для него не будет отправлен.
+    void cancel();
+
+    /// true, если поиск запущен и его результат ещё не доставлен.
+    bool isRunning() const { return running; }
+
+signals:
+    /// Завершена очередная итерация углубления; stats – строка статистики поиска (SearchStats::summary).
+    void progress(int depth, qint64 nodes, const QString& stats);
+
+    /// Поиск завершён; (row, col) – найденный ход или (-1, -1), если ходов нет.
+    void finished(int row, int col);
+
+private:
+    // Останавливает поток поиска и дожидается его завершения.
+    void stopWorker();
+
+    std::unique_ptr<EngineSession> ai; // ИИ; таблица транспозиций сохраняется между поисками.
+    QThread* worker = nullptr;   // Поток текущего поиска.
+    quint64 generation = 0;      // Номер текущего поиска: результаты старых поисков отбрасываются.
+    bool running = false;        // Поиск запущен, результат ещё не получен.
+};
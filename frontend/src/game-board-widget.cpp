@@ -3,25 +3,31 @@
 #include <QHBoxLayout>
 #include <QMouseEvent>
 #include <QMessageBox>
+#include <QFileDialog>
+#include <QStandardPaths>
+#include <QDir>
+#include <algorithm>
 
 /* ---------------------- BoardView ------------------------
  *
  * Класс BoardView наследуется от QGraphicsView и обрабатывает клики по игровому полю.
  */
-BoardView::BoardView(QWidget *parent)
-    : QGraphicsView(parent)
+BoardView::BoardView(int boardSize, int cellSize, QWidget *parent)
+    : QGraphicsView(parent),
+      cellSize(cellSize)
 {
     setRenderHint(QPainter::Antialiasing);
-    // Фиксированный размер поля: 15 клеток по 30px плюс небольшие отступы.
-    setFixedSize(470, 470);
-    setSceneRect(0, 0, 450, 450);
+    // Фиксированный размер поля: boardSize клеток по cellSize пикселей плюс небольшие отступы.
+    const int side = boardSize * cellSize;
+    setFixedSize(side + 20, side + 20);
+    setSceneRect(0, 0, side, side);
 }
 
 void BoardView::mousePressEvent(QMouseEvent *event)
 {
     QPointF pt = mapToScene(event->pos());
-    int row = pt.y() / 30;
-    int col = pt.x() / 30;
+    int row = pt.y() / cellSize;
+    int col = pt.x() / cellSize;
     emit cellClicked(row, col);
     QGraphicsView::mousePressEvent(event);
 }
@@ -32,35 +38,49 @@ void BoardView::mousePressEvent(QMouseEvent *event)
  * Отвечает за отрисовку доски, обработку ходов (игрока и ИИ),
  * сохранение и отмену ходов, а также подсказки и возврат в меню.
  */
-GameBoardWidget::GameBoardWidget(bool playerVsBot, int difficulty, QWidget *parent)
+GameBoardWidget::GameBoardWidget(bool playerVsBot, int difficulty, int boardSize, GameLogicBase::Rules rules,
+                                 QWidget *parent)
     : QWidget(parent),
+      game(EngineSession::create(boardSize)),
       botDepth(difficulty),
-      playerVsBot(playerVsBot)
+      playerVsBot(playerVsBot),
+      cellSize(BOARD_PIXELS / boardSize)
 {
+    game->setRules(rules, GameLogic::Human);
     setupUI();
     drawBoard();
     connect(boardView, &BoardView::cellClicked, this, &GameBoardWidget::onCellClicked);
 
+    // Таймер только выдерживает паузу перед показом уже найденного хода бота.
     botTimer = new QTimer(this);
-    botTimer->setInterval(1000);
-    connect(botTimer, &QTimer::timeout, this, &GameBoardWidget::onBotMove);
+    botTimer->setSingleShot(true);
+    connect(botTimer, &QTimer::timeout, this, &GameBoardWidget::onBotMoveReady);
+
+    searchJob = new SearchJob(boardSize, this);
+    connect(searchJob, &SearchJob::finished, this, &GameBoardWidget::onSearchFinished);
+    connect(searchJob, &SearchJob::progress, this, &GameBoardWidget::onSearchProgress);
 
     // Определение первого хода:
     // В режиме "Игрок против Бота" первым ходом всегда является игрок.
     // В режиме "Бот против Бота" мы чередуем ходы, начиная с первого бота, которого мы помечаем как GameLogic::Human.
-    if(playerVsBot)
-        currentTurn = GameLogic::Human;
-    else {
-        currentTurn = GameLogic::Human;  // Первый бот (отобразится голубым)
-        botTimer->start();
-    }
+    currentTurn = GameLogic::Human;  // В режиме "Бот против Бота" – первый бот (отобразится голубым)
+
+    // Журнал партий: каждая партия дописывается в него по ходу игры; у каждого размера доски свой журнал.
+    const QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir().mkpath(dataDir);
+    const QString journal = (boardSize == GameLogic::BOARD_SIZE) ? QString("games.gmk")
+                                                                 : QString("games-%1.gmk").arg(boardSize);
+    if (recorder.open((dataDir + "/" + journal).toStdString(), boardSize))
+        recorder.beginGame(GameLogic::Human);
     updateBoard();
+    if(!playerVsBot)
+        onBotMove();
 }
 
 void GameBoardWidget::setupUI()
 {
     QVBoxLayout* mainLayout = new QVBoxLayout(this);
-    boardView = new BoardView(this);
+    boardView = new BoardView(game->boardSize(), cellSize, this);
     scene = new QGraphicsScene(this);
     boardView->setScene(scene);
     mainLayout->addWidget(boardView);
@@ -68,25 +88,34 @@ void GameBoardWidget::setupUI()
     QHBoxLayout* buttonLayout = new QHBoxLayout();
     btnReturn = new QPushButton("В меню", this);
     btnUndo   = new QPushButton("Отменить ход", this);
+    btnRedo   = new QPushButton("Вернуть ход", this);
     btnHint   = new QPushButton("Подсказка", this);
     btnSave   = new QPushButton("Сохранить игру", this);
     btnLoad   = new QPushButton("Загрузить игру", this);
     buttonLayout->addWidget(btnReturn);
     buttonLayout->addWidget(btnUndo);
+    buttonLayout->addWidget(btnRedo);
     buttonLayout->addWidget(btnHint);
     buttonLayout->addWidget(btnSave);
     buttonLayout->addWidget(btnLoad);
     mainLayout->addLayout(buttonLayout);
 
-    // Для режима "Бот против Бота" кнопка отмены отключена.
-    if(!playerVsBot)
+    // Для режима "Бот против Бота" кнопки отмены и возврата хода отключены.
+    if(!playerVsBot) {
         btnUndo->setEnabled(false);
+        btnRedo->setEnabled(false);
+    }
 
     statusLabel = new QLabel("Ход: ", this);
     mainLayout->addWidget(statusLabel);
+    searchLabel = new QLabel(this);
+    searchLabel->setStyleSheet("font-size: 12px; color: #555555;");
+    searchLabel->setWordWrap(true);
+    mainLayout->addWidget(searchLabel);
 
     connect(btnReturn, &QPushButton::clicked, this, &GameBoardWidget::onReturnToMenu);
     connect(btnUndo,   &QPushButton::clicked, this, &GameBoardWidget::onUndo);
+    connect(btnRedo,   &QPushButton::clicked, this, &GameBoardWidget::onRedo);
     connect(btnHint,   &QPushButton::clicked, this, &GameBoardWidget::onHint);
     connect(btnSave,   &QPushButton::clicked, this, &GameBoardWidget::onSaveGame);
     connect(btnLoad,   &QPushButton::clicked, this, &GameBoardWidget::onLoadGame);
@@ -102,19 +131,20 @@ void GameBoardWidget::setupUI()
 void GameBoardWidget::drawBoard()
 {
     scene->clear();
+    const int size = game->boardSize();
     // Рисуем горизонтальные и вертикальные линии сетки.
-    for (int i = 0; i <= GameLogic::BOARD_SIZE; ++i) {
-        scene->addLine(0, i * cellSize, GameLogic::BOARD_SIZE * cellSize, i * cellSize, QPen(Qt::black));
-        scene->addLine(i * cellSize, 0, i * cellSize, GameLogic::BOARD_SIZE * cellSize, QPen(Qt::black));
+    for (int i = 0; i <= size; ++i) {
+        scene->addLine(0, i * cellSize, size * cellSize, i * cellSize, QPen(Qt::black));
+        scene->addLine(i * cellSize, 0, i * cellSize, size * cellSize, QPen(Qt::black));
     }
     // Отрисовываем фишки для каждой клетки, если она занята.
-    for (int i = 0; i < GameLogic::BOARD_SIZE; i++){
-        for (int j = 0; j < GameLogic::BOARD_SIZE; j++){
-            int piece = game.board[i][j];
+    for (int i = 0; i < size; i++){
+        for (int j = 0; j < size; j++){
+            int piece = game->cell(i, j);
             if(piece != GameLogic::None) {
                 // Цвет определяется по коду: для GameLogic::Human (первый бот или игрок) — синий; для GameLogic::AI (второй бот) — красный.
                 QColor color = (piece == GameLogic::Human) ? Qt::blue : Qt::red;
-                int margin = 4;
+                int margin = cellSize / 8;
                 scene->addEllipse(j * cellSize + margin, i * cellSize + margin,
                                   cellSize - 2 * margin, cellSize - 2 * margin,
                                   QPen(Qt::black), QBrush(color));
@@ -127,18 +157,18 @@ void GameBoardWidget::updateBoard()
 {
     drawBoard();
     QString turnText;
-    int winner = game.checkWinner();
+    int winner = game->checkWinner();
     if(winner != GameLogic::None){
         turnText = (winner == GameLogic::Human) ? "Победил Первый бот!" : "Победил Второй бот!";
         btnHint->setEnabled(false);
         btnUndo->setEnabled(false);
-        botTimer->stop();
+        cancelSearch();
     }
-    else if (game.getAvailableMoves().empty()){
+    else if (game->isBoardFull()){
         turnText = "Ничья!";
         btnHint->setEnabled(false);
         btnUndo->setEnabled(false);
-        botTimer->stop();
+        cancelSearch();
     }
     else {
         // Для режима "Игрок против Бота" отображается "Ход: Игрок" или "Ход: Бот".
@@ -154,64 +184,110 @@ void GameBoardWidget::updateBoard()
 void GameBoardWidget::onCellClicked(int row, int col)
 {
     // Обработка кликов работает только в режиме "Игрок против Бота".
-    if(game.checkWinner() != GameLogic::None || !playerVsBot)
+    if(game->checkWinner() != GameLogic::None || !playerVsBot)
         return;
     
     // Если сейчас не очередь игрока, игнорируем клик.
     if(currentTurn != GameLogic::Human)
         return;
 
-    if(game.isMoveValid(row, col)){
-        game.makeMove(row, col, GameLogic::Human);
+    if(game->isForbidden(row, col, GameLogic::Human)){
+        statusLabel->setText("Ход запрещён правилами рэндзю");
+        return;
+    }
+    if(game->isMoveValid(row, col)){
+        playMove(row, col, GameLogic::Human);
         currentTurn = GameLogic::AI;
-        addMoveToHistory();
         updateBoard();
         if(checkGameOver()) return;
-        QTimer::singleShot(1000, this, SLOT(onBotMove()));
+        onBotMove();
     }
 }
 
 void GameBoardWidget::onBotMove()
 {
-    // Если игра окончена, прекращаем работу таймера.
-    if(game.checkWinner() != GameLogic::None) {
-        botTimer->stop();
+    // Если игра окончена или бот уже думает, новый поиск не запускаем.
+    if(game->checkWinner() != GameLogic::None || isBotThinking())
         return;
-    }
     // В режиме "Игрок против Бота" выполняем ход ИИ только если его очередь.
     if(playerVsBot && currentTurn != GameLogic::AI)
         return;
-    
-    // Если бот против бота, выбираем лучшую ставку в зависимости от currentTurn:
-    std::pair<int,int> move;
-    if(playerVsBot) {
-         // В режиме "Игрок против Бота" ход всегда для AI (maximizing = true).
-         move = ai.getBestMove(game, botDepth);
-         // Затем, после хода, переключаем ход на игрока.
-         game.makeMove(move.first, move.second, GameLogic::AI);
-         currentTurn = GameLogic::Human;
-    } else {
-         // В режиме "Бот против Бота" ход зависит от currentTurn:
-         if(currentTurn == GameLogic::AI) {
-             // Второй бот – для него вызываем оптимальный ход в максимизирующем режиме.
-             move = ai.getBestMove(game, botDepth, true);
-             game.makeMove(move.first, move.second, GameLogic::AI);
-             currentTurn = GameLogic::Human;
-         } else {
-             // Первый бот – для него вызываем оптимальный ход в минимизирующем режиме.
-             move = ai.getBestMove(game, botDepth, false);
-             game.makeMove(move.first, move.second, GameLogic::Human);
-             currentTurn = GameLogic::AI;
-         }
+
+    // Если поиск подсказки ещё идёт, он отменяется: ход бота важнее.
+    cancelSearch();
+
+    // В режиме "Игрок против Бота" ход всегда ищется для AI (maximizing = true).
+    // В режиме "Бот против Бота" второй бот (AI) максимизирует, первый (Human) – минимизирует.
+    SearchLimits limits;
+    limits.maxDepth = botDepth;
+    pendingSearch = PendingSearch::BotMove;
+    paceClock.start();
+    searchJob->start(*game, limits, currentTurn == GameLogic::AI);
+    searchLabel->setText("Бот думает...");
+}
+
+void GameBoardWidget::onSearchFinished(int row, int col)
+{
+    PendingSearch purpose = pendingSearch;
+    pendingSearch = PendingSearch::Nothing;
+    searchLabel->clear();
+
+    if(purpose == PendingSearch::Hint) {
+        if(row == -1)
+            return;
+        int margin = cellSize / 8;
+        QPen pen(Qt::green);
+        pen.setWidth(3);
+        scene->addEllipse(col * cellSize + margin, row * cellSize + margin,
+                          cellSize - 2 * margin, cellSize - 2 * margin,
+                          pen, QBrush(Qt::NoBrush));
+        return;
     }
-    addMoveToHistory();
+    if(purpose != PendingSearch::BotMove || row == -1)
+        return;
+
+    // Ход найден; показываем его не раньше, чем через MOVE_DELAY_MS после начала поиска.
+    pendingMove = std::make_pair(row, col);
+    qint64 wait = MOVE_DELAY_MS - paceClock.elapsed();
+    botTimer->start(wait > 0 ? int(wait) : 0);
+}
+
+void GameBoardWidget::onSearchProgress(int depth, qint64 nodes, const QString& stats)
+{
+    Q_UNUSED(nodes);
+    QString who = (pendingSearch == PendingSearch::Hint) ? "Подсказка" : "Бот думает";
+    // Строка состояния: глубина и статистика поиска (узлы, TT, отсечения, время, вариант).
+    searchLabel->setText(QString("%1: глубина %2, %3").arg(who).arg(depth).arg(stats));
+}
+
+void GameBoardWidget::onBotMoveReady()
+{
+    GameLogic::Player player = static_cast<GameLogic::Player>(currentTurn);
+    playMove(pendingMove.first, pendingMove.second, player);
+    currentTurn = (player == GameLogic::AI) ? GameLogic::Human : GameLogic::AI;
     updateBoard();
     if(checkGameOver()) return;
+    // В режиме "Бот против Бота" сразу начинаем искать ход следующего бота.
+    if(!playerVsBot)
+        onBotMove();
 }
 
-void GameBoardWidget::onReturnToMenu()
+bool GameBoardWidget::isBotThinking() const
 {
+    return pendingSearch == PendingSearch::BotMove || botTimer->isActive();
+}
+
+void GameBoardWidget::cancelSearch()
+{
+    searchJob->cancel();
     botTimer->stop();
+    pendingSearch = PendingSearch::Nothing;
+    searchLabel->clear();
+}
+
+void GameBoardWidget::onReturnToMenu()
+{
+    cancelSearch();
     emit returnToMenu();
 }
 
@@ -219,93 +295,119 @@ void GameBoardWidget::onUndo()
 {
     if(!playerVsBot)
         return;
-    int historySize = moveHistory.size();
-    if(historySize > 0) {
-        moveHistory.pop_back();
-        if (moveHistory.size() > 0) {
-            moveHistory.pop_back();
-        }
-        if(moveHistory.empty()){
-            for(int i = 0; i < GameLogic::BOARD_SIZE; i++){
-                for(int j = 0; j < GameLogic::BOARD_SIZE; j++){
-                    game.board[i][j] = GameLogic::None;
-                }
-            }
-            currentTurn = GameLogic::Human;
-        } else {
-            const SavedState &lastState = moveHistory.back();
-            for(int i = 0; i < GameLogic::BOARD_SIZE; i++){
-                for(int j = 0; j < GameLogic::BOARD_SIZE; j++){
-                    game.board[i][j] = lastState.board[i][j];
-                }
-            }
-            currentTurn = lastState.currentPlayer;
+    if(game->moveCount() > 0) {
+        // Если бот ещё думает над ответом, отменяется только ход игрока.
+        bool botThinking = isBotThinking();
+        cancelSearch();
+        game->takeBack();
+        recorder.appendUndo();
+        if (!botThinking && game->moveCount() > 0) {
+            game->takeBack();
+            recorder.appendUndo();
         }
+        // Ходит тот, чей ход отменён последним.
+        currentTurn = game->nextRedoMove().player;
         updateBoard();
     }
 }
 
-void GameBoardWidget::onHint()
+void GameBoardWidget::onRedo()
 {
-    if(game.checkWinner() != GameLogic::None)
+    if(!playerVsBot || !game->canRedo())
         return;
-    std::pair<int, int> hintMove = ai.getBestMove(game, botDepth);
-    if(hintMove.first == -1)
+    cancelSearch();
+    // Ход игрока возвращается вместе с ответом бота, если он тоже был отменён.
+    GameLogic::RecordedMove move = game->nextRedoMove();
+    game->redoMove();
+    recorder.appendMove(move.row, move.col);
+    if (move.player == GameLogic::Human && game->canRedo()) {
+        move = game->nextRedoMove();
+        game->redoMove();
+        recorder.appendMove(move.row, move.col);
+    }
+    GameLogic::Player player = static_cast<GameLogic::Player>(move.player);
+    currentTurn = (player == GameLogic::AI) ? GameLogic::Human : GameLogic::AI;
+    updateBoard();
+    if(checkGameOver()) return;
+    onBotMove();
+}
+
+void GameBoardWidget::onHint()
+{
+    // Подсказка ищется в фоне; пока думает бот или уже ищется подсказка, запрос игнорируется.
+    if(game->checkWinner() != GameLogic::None || pendingSearch != PendingSearch::Nothing || botTimer->isActive())
         return;
-    int margin = 4;
-    QPen pen(Qt::green);
-    pen.setWidth(3);
-    scene->addEllipse(hintMove.second * cellSize + margin, hintMove.first * cellSize + margin,
-                      cellSize - 2 * margin, cellSize - 2 * margin,
-                      pen, QBrush(Qt::NoBrush));
+    SearchLimits limits;
+    limits.maxDepth = botDepth;
+    pendingSearch = PendingSearch::Hint;
+    // Ход ищется за сторону, чья очередь: в рэндзю чёрными играет человек, и поиск за него
+    // не предложит запрещённую клетку, которую потом отвергнет onCellClicked.
+    searchJob->start(*game, limits, currentTurn == GameLogic::AI);
+    searchLabel->setText("Подсказка: поиск...");
 }
 
 void GameBoardWidget::onSaveGame()
 {
-    lastSavedState.board.clear();
-    lastSavedState.board.resize(GameLogic::BOARD_SIZE, std::vector<int>(GameLogic::BOARD_SIZE, GameLogic::None));
-    for (int i = 0; i < GameLogic::BOARD_SIZE; i++){
-        for (int j = 0; j < GameLogic::BOARD_SIZE; j++){
-            lastSavedState.board[i][j] = game.board[i][j];
-        }
-    }
-    lastSavedState.currentPlayer = currentTurn;
-    hasSavedState = true;
-    QMessageBox::information(this, "Сохранение", "Игра сохранена.");
+    QString path = QFileDialog::getSaveFileName(this, "Сохранение", QDir::homePath() + "/gomoku.gmk",
+                                                "Партии gomoku-qt (*.gmk);;Текст (*.txt)");
+    if(path.isEmpty())
+        return;
+    SavedGame saved;
+    saved.boardSize = game->boardSize();
+    saved.moves = game->moveLog();
+    saved.winner = game->checkWinner();
+    saved.finished = saved.winner != GameLogic::None || game->isBoardFull();
+    std::vector<SavedGame> games(1, saved);
+    bool ok = path.endsWith(".txt", Qt::CaseInsensitive)
+                  ? GameArchive::exportText(path.toStdString(), games)
+                  : GameArchive::save(path.toStdString(), games);
+    if(ok)
+        QMessageBox::information(this, "Сохранение", "Игра сохранена.");
+    else
+        QMessageBox::warning(this, "Сохранение", "Не удалось записать файл.");
 }
 
 void GameBoardWidget::onLoadGame()
 {
-    if(!hasSavedState){
+    QString path = QFileDialog::getOpenFileName(this, "Загрузка",
+                                                QStandardPaths::writableLocation(QStandardPaths::AppDataLocation),
+                                                "Партии gomoku-qt (*.gmk)");
+    if(path.isEmpty())
+        return;
+    std::vector<SavedGame> games;
+    std::string error;
+    if(!GameArchive::load(path.toStdString(), games, error)){
+        QMessageBox::warning(this, "Загрузка", QString::fromStdString(error));
+        return;
+    }
+    // Загружается последняя непустая партия файла (в журнале – последняя сыгранная).
+    auto it = std::find_if(games.rbegin(), games.rend(), [](const SavedGame &g) { return !g.moves.empty(); });
+    if(it == games.rend()){
         QMessageBox::warning(this, "Загрузка", "Нет сохраненной игры.");
         return;
     }
-    for (int i = 0; i < GameLogic::BOARD_SIZE; i++){
-        for (int j = 0; j < GameLogic::BOARD_SIZE; j++){
-            game.board[i][j] = lastSavedState.board[i][j];
-        }
+    if(it->boardSize != game->boardSize()){
+        QMessageBox::warning(this, "Загрузка",
+                             QString("Партия сыграна на доске %1x%1.").arg(it->boardSize));
+        return;
     }
-    moveHistory.clear();
-    SavedState state;
-    state.board = lastSavedState.board;
-    state.currentPlayer = lastSavedState.currentPlayer;
-    moveHistory.push_back(state);
-    currentTurn = state.currentPlayer;
+    cancelSearch();
+    game->reset();
+    recorder.beginGame(it->firstPlayer);
+    for (const GameLogic::RecordedMove &move : it->moves)
+        playMove(move.row, move.col, static_cast<GameLogic::Player>(move.player));
+    currentTurn = it->sideToMove();
     updateBoard();
     QMessageBox::information(this, "Загрузка", "Игра загружена.");
+    // Если по загруженной позиции ходит бот, запускаем его поиск.
+    onBotMove();
 }
 
-void GameBoardWidget::addMoveToHistory()
+// Ход партии: выполняется и сразу дописывается в журнал партий.
+void GameBoardWidget::playMove(int row, int col, GameLogic::Player player)
 {
-    SavedState state;
-    state.board.resize(GameLogic::BOARD_SIZE, std::vector<int>(GameLogic::BOARD_SIZE, GameLogic::None));
-    for (int i = 0; i < GameLogic::BOARD_SIZE; i++){
-        for (int j = 0; j < GameLogic::BOARD_SIZE; j++){
-            state.board[i][j] = game.board[i][j];
-        }
-    }
-    state.currentPlayer = currentTurn;
-    moveHistory.push_back(state);
+    game->playMove(row, col, player);
+    recorder.appendMove(row, col);
 }
 
 /**
@@ -319,22 +421,24 @@ void GameBoardWidget::addMoveToHistory()
  */
 bool GameBoardWidget::checkGameOver()
 {
-    int winner = game.checkWinner();
+    int winner = game->checkWinner();
     if(winner != GameLogic::None){
         updateBoard();
         QString winnerText = (winner == GameLogic::Human) ? "Игрок победил!" : "Бот победил!";
         // В режиме Bot vs Bot уточним сообщение:
         if(!playerVsBot)
             winnerText = (winner == GameLogic::Human) ? "Первый бот победил!" : "Второй бот победил!";
+        cancelSearch();
+        recorder.endGame(winner);
         QMessageBox::information(this, "Игра окончена", winnerText);
-        botTimer->stop();
         return true;
     }
     
-    if(game.getAvailableMoves().empty()){
+    if(game->isBoardFull()){
         updateBoard();
+        cancelSearch();
+        recorder.endGame(GameLogic::None);
         QMessageBox::information(this, "Игра окончена", "Ничья!");
-        botTimer->stop();
         return true;
     }
     return false;
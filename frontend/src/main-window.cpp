@@ -16,14 +16,15 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent)
     connect(menuWidget, &MenuWidget::startGameRequested, this, &MainWindow::startGame);
 }
 
-void MainWindow::startGame(bool playerVsBot, int difficulty)
+void MainWindow::startGame(bool playerVsBot, int difficulty, int boardSize, int rules)
 {
     // Если уже существует игровое поле — удаляем его и создаём новое
     if (gameBoardWidget) {
         centralStack->removeWidget(gameBoardWidget);
         gameBoardWidget->deleteLater();
     }
-    gameBoardWidget = new GameBoardWidget(playerVsBot, difficulty, this);
+    gameBoardWidget = new GameBoardWidget(playerVsBot, difficulty, boardSize,
+                                          static_cast<GameLogicBase::Rules>(rules), this);
     centralStack->addWidget(gameBoardWidget);
     centralStack->setCurrentWidget(gameBoardWidget);
     // Подписываемся на сигнал возврата в меню
@@ -1,4 +1,5 @@
 #include "../include/menu-widget.h"
+#include "../../backend/include/engine-session.h"
 
 MenuWidget::MenuWidget(QWidget *parent) : QWidget(parent)
 {
@@ -23,6 +24,23 @@ MenuWidget::MenuWidget(QWidget *parent) : QWidget(parent)
     difficultyCombo->addItem("Трудный", 4);
     mainLayout->addWidget(difficultyCombo);
 
+    // Размер доски: классическая 15x15, доска го 19x19 и 20x20 (Gomocup freestyle).
+    QLabel* boardSizeLabel = new QLabel("Выберите размер доски:", this);
+    mainLayout->addWidget(boardSizeLabel);
+    boardSizeCombo = new QComboBox(this);
+    for (int size : EngineSession::supportedBoardSizes())
+        boardSizeCombo->addItem(QString("%1x%1").arg(size), size);
+    mainLayout->addWidget(boardSizeCombo);
+
+    // Правила: свободный стиль (пять и больше), ровно пять, рэндзю (запреты для чёрных – игрока).
+    QLabel* rulesLabel = new QLabel("Выберите правила:", this);
+    mainLayout->addWidget(rulesLabel);
+    rulesCombo = new QComboBox(this);
+    rulesCombo->addItem("Свободный стиль", int(GameLogicBase::Freestyle));
+    rulesCombo->addItem("Стандарт (ровно пять)", int(GameLogicBase::Standard));
+    rulesCombo->addItem("Рэндзю", int(GameLogicBase::Renju));
+    mainLayout->addWidget(rulesCombo);
+
     // Выбор режима игры
     QLabel* modeLabel = new QLabel("Выберите режим игры:", this);
     mainLayout->addWidget(modeLabel);
@@ -56,5 +74,6 @@ void MenuWidget::onStartButtonClicked()
     if (rbBotVsBot->isChecked()) {
         difficulty = 3;
     }
-    emit startGameRequested(playerVsBot, difficulty);
+    emit startGameRequested(playerVsBot, difficulty, boardSizeCombo->currentData().toInt(),
+                            rulesCombo->currentData().toInt());
 }
@@ -0,0 +1,77 @@
+#include "../include/search-job.h"
+#include <QCoreApplication>
+#include <QFileInfo>
+
+SearchJob::SearchJob(int boardSize, QObject *parent)
+    : QObject(parent),
+      ai(EngineSession::create(boardSize))
+{
+    // Поиск использует все доступные ядра (Lazy SMP).
+    ai->setThreadCount(QThread::idealThreadCount());
+
+    // Дебютная книга, если она лежит рядом с программой (собирается gomoku-book-builder);
+    // книга для другого размера доски просто не находит позиций.
+    const QString bookPath = QCoreApplication::applicationDirPath() + "/gomoku.book";
+    if (QFileInfo::exists(bookPath)) {
+        auto book = std::make_shared<OpeningBook>();
+        if (book->open(bookPath.toStdString()))
+            ai->setOpeningBook(book);
+    }
+}
+
+SearchJob::~SearchJob()
+{
+    stopWorker();
+}
+
+void SearchJob::start(const EngineSession &game, const SearchLimits &limits, bool maximizingPlayer)
+{
+    stopWorker();
+    ai->clearStopRequest();
+    ai->setRules(game.rules(), game.blackPlayer());
+    running = true;
+    const quint64 id = ++generation;
+
+    // Промежуточные результаты и итог пересылаются в поток GUI через очередь событий;
+    // там же проверяется, что поиск не был отменён или заменён новым.
+    ai->setProgressCallback([this, id](const SearchResult &result) {
+        const int depth = result.depth;
+        const qint64 nodes = result.nodes;
+        const QString stats = QString::fromStdString(result.stats.summary());
+        QMetaObject::invokeMethod(this, [this, id, depth, nodes, stats]() {
+            if (id == generation && running)
+                emit progress(depth, nodes, stats);
+        }, Qt::QueuedConnection);
+    });
+
+    const std::vector<GameLogicBase::RecordedMove> moves = game.moveLog();
+    worker = QThread::create([this, id, moves, limits, maximizingPlayer]() {
+        SearchResult result = ai->searchFrom(moves, limits, maximizingPlayer);
+        const int row = result.move.first;
+        const int col = result.move.second;
+        QMetaObject::invokeMethod(this, [this, id, row, col]() {
+            if (id != generation || !running)
+                return;
+            running = false;
+            emit finished(row, col);
+        }, Qt::QueuedConnection);
+    });
+    worker->start();
+}
+
+void SearchJob::cancel()
+{
+    running = false;
+    ++generation;
+    ai->requestStop();
+}
+
+void SearchJob::stopWorker()
+{
+    if (!worker)
+        return;
+    ai->requestStop();
+    worker->wait();
+    delete worker;
+    worker = nullptr;
+}
@@ -0,0 +1,282 @@
+/*
+ * engine-tests.cpp
+ *
+ * Проверки движка, запускаемые через ctest (цель gomoku-engine-tests).
+ *
+ * Инкрементальная оценка GameLogic::evaluation() сверяется с полным пересчётом
+ * PatternEvaluator::evaluateBoard, а он без шаблонов с разрывом – с эталонной оценкой
+ * AlphaBetaAI::referenceEvaluate (исходная таблица цепочек и открытых концов).
+ * Позиции берутся из случайных партий с отменой ходов на досках всех собранных размеров.
+ *
+ * Запреты рэндзю (RenjuRules по кэшу форм линий) сверяются с наивной проверкой, которая
+ * ставит камень и заново считает пятёрки, четвёрки и тройки по клеткам доски, на случайных
+ * позициях и на наборе известных позиций 3-3, 4-4 и длинного ряда. Наивная проверка идёт
+ * на ту же глубину, что и RenjuRules: открытость тройки проверяется один раз, а тройки
+ * у хода, достраивающего тройку, считаются открытыми.
+ *
+ * Программа выводит описание каждого расхождения и завершается с ненулевым кодом,
+ * если хотя бы одна проверка не прошла.
+ */
+
+#include "gomoku-engine.h"
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+int failures = 0; // Число не прошедших проверок.
+
+// Печатает расхождение и засчитывает проверку как не прошедшую.
+void fail(const char *test, const char *what, int expected, int actual, int move) {
+    if (failures++ < 20)
+        std::printf("%s: %s – ожидалось %d, получено %d (ход %d)\n", test, what, expected, actual, move);
+}
+
+/**
+ * @brief checkEvaluation Сверяет три оценки позиции.
+ *
+ * evaluation() и evaluateBoard(game) должны совпадать всегда; evaluateBoard(game, false)
+ * и referenceEvaluate – в позициях без победителя и при правилах свободного стиля
+ * (эталон не знает, что длинный ряд может не выигрывать).
+ */
+template <int N>
+void checkEvaluation(const BasicGameLogic<N> &game, int move) {
+    int incremental = game.evaluation();
+    int full = PatternEvaluator::evaluateBoard(game);
+    if (incremental != full)
+        fail("evaluation", "evaluation() != evaluateBoard(game)", full, incremental, move);
+    if (game.getRules() != GameLogicBase::Freestyle || game.checkWinner() != GameLogicBase::None)
+        return;
+    int chains = PatternEvaluator::evaluateBoard(game, false);
+    int reference = BasicAlphaBetaAI<N>::referenceEvaluate(game);
+    if (chains != reference)
+        fail("evaluation", "evaluateBoard(game, false) != referenceEvaluate", reference, chains, move);
+}
+
+/**
+ * @brief randomGamesEvaluation Случайные партии с отменой ходов.
+ *
+ * Ходы выбираются среди кандидатов фронтира (иногда – в любую пустую клетку), примерно
+ * каждый пятый ход отменяется, а партия заканчивается победой или заполнением доски.
+ * Оценки сверяются после каждого хода и каждой отмены.
+ */
+template <int N>
+void randomGamesEvaluation(std::mt19937 &random, int games, GameLogicBase::Rules rules) {
+    using Game = BasicGameLogic<N>;
+    for (int g = 0; g < games; g++) {
+        Game game;
+        game.setRules(rules, GameLogicBase::Human);
+        GameLogicBase::Player player = GameLogicBase::Human;
+        int move = 0;
+        while (game.checkWinner() == GameLogicBase::None && !game.isBoardFull()) {
+            if (game.stoneCount() > 0 && random() % 5 == 0) {
+                game.takeBack();
+                player = (player == GameLogicBase::Human) ? GameLogicBase::AI : GameLogicBase::Human;
+                checkEvaluation(game, move);
+                continue;
+            }
+            int cell;
+            if (game.candidateCount() > 0 && random() % 8 != 0) {
+                cell = game.candidateAt(int(random() % unsigned(game.candidateCount())));
+            } else {
+                do
+                    cell = int(random() % unsigned(Game::CELL_COUNT));
+                while (!game.isMoveValid(cell / N, cell % N));
+            }
+            game.playMove(cell / N, cell % N, player);
+            player = (player == GameLogicBase::Human) ? GameLogicBase::AI : GameLogicBase::Human;
+            checkEvaluation(game, ++move);
+        }
+    }
+}
+
+/**
+ * @brief NaiveRenju Наивная проверка запретов рэндзю по копии доски.
+ *
+ * Камни чёрных – 1, белых – 2. Ход ставится на доску, и по каждой из 4 линий через него
+ * заново перебираются клетки, дающие ровно пять в ряд, без каких-либо таблиц.
+ */
+template <int N>
+class NaiveRenju {
+public:
+    explicit NaiveRenju(const BasicGameLogic<N> &game) : cells(N * N, 0) {
+        for (int row = 0; row < N; row++) {
+            for (int col = 0; col < N; col++) {
+                int player = game.board[row][col];
+                if (player != GameLogicBase::None)
+                    cells[row * N + col] = (player == game.getBlackPlayer()) ? 1 : 2;
+            }
+        }
+    }
+
+    // Запрещён ли ход чёрных в пустую клетку; depth – глубина проверки открытости троек.
+    bool isForbidden(int row, int col, int depth) {
+        cells[row * N + col] = 1;
+        bool five = false, overline = false;
+        int fourCount = 0, threeCount = 0;
+        for (int d = 0; d < 4; d++) {
+            int length = run(row, col, d);
+            five = five || length == 5;
+            overline = overline || length > 5;
+            fourCount += fours(row, col, d);
+        }
+        if (!five && !overline && fourCount < 2) {
+            for (int d = 0; d < 4; d++)
+                threeCount += fours(row, col, d) == 0 && three(row, col, d, depth);
+        }
+        cells[row * N + col] = 0;
+        return !five && (overline || fourCount >= 2 || threeCount >= 2);
+    }
+
+private:
+    std::vector<int> cells;
+
+    int at(int row, int col) const {
+        return (row < 0 || row >= N || col < 0 || col >= N) ? -1 : cells[row * N + col];
+    }
+
+    // Длина ряда чёрных через (row, col) по направлению d.
+    int run(int row, int col, int d) const {
+        static const int dr[4] = {0, 1, 1, -1}, dc[4] = {1, 0, 1, 1};
+        int length = 1;
+        for (int sign = -1; sign <= 1; sign += 2) {
+            for (int k = 1; at(row + sign * k * dr[d], col + sign * k * dc[d]) == 1; k++)
+                length++;
+        }
+        return length;
+    }
+
+    // Смещения пустых клеток линии d, после хода в которые ряд через (row, col) – ровно пять.
+    int fiveCells(int row, int col, int d, int offsets[2]) {
+        static const int dr[4] = {0, 1, 1, -1}, dc[4] = {1, 0, 1, 1};
+        int count = 0;
+        for (int k = -5; k <= 5; k++) {
+            int r = row + k * dr[d], c = col + k * dc[d];
+            if (k == 0 || at(r, c) != 0)
+                continue;
+            cells[r * N + c] = 1;
+            if (run(row, col, d) == 5 && count < 2)
+                offsets[count++] = k;
+            cells[r * N + c] = 0;
+        }
+        return count;
+    }
+
+    // Число четвёрок на линии d (открытая четвёрка – одна).
+    int fours(int row, int col, int d) {
+        int offsets[2];
+        int count = fiveCells(row, col, d, offsets);
+        return (count == 2 && offsets[1] - offsets[0] == 5) ? 1 : count;
+    }
+
+    // Есть ли на линии d тройка: ход в пустую клетку рядом даёт открытую четвёрку,
+    // и при depth > 0 этот ход сам не запрещён.
+    bool three(int row, int col, int d, int depth) {
+        static const int dr[4] = {0, 1, 1, -1}, dc[4] = {1, 0, 1, 1};
+        for (int k = -4; k <= 4; k++) {
+            int r = row + k * dr[d], c = col + k * dc[d];
+            if (k == 0 || at(r, c) != 0)
+                continue;
+            cells[r * N + c] = 1;
+            int offsets[2];
+            bool openFour = fiveCells(row, col, d, offsets) == 2 && offsets[1] - offsets[0] == 5;
+            cells[r * N + c] = 0;
+            if (openFour && (depth == 0 || !isForbidden(r, c, depth - 1)))
+                return true;
+        }
+        return false;
+    }
+};
+
+/**
+ * @brief randomRenjuPositions Сверяет запреты на случайных позициях.
+ *
+ * Позиция – от 4 до 40 случайных камней вокруг центра (чёрных примерно на один больше),
+ * после чего для каждой пустой клетки сравниваются isForbidden за чёрных и наивная проверка;
+ * за белых ход не должен быть запрещён никогда.
+ */
+void randomRenjuPositions(std::mt19937 &random, int positions) {
+    const int N = 15;
+    for (int p = 0; p < positions; p++) {
+        BasicGameLogic<N> game;
+        game.setRules(GameLogicBase::Renju, GameLogicBase::Human);
+        int stones = 4 + int(random() % 37);
+        for (int i = 0; i < stones; i++) {
+            int row = N / 2 - 4 + int(random() % 9), col = N / 2 - 4 + int(random() % 9);
+            if (game.isMoveValid(row, col))
+                game.makeMove(row, col, (i % 2 == 0) ? GameLogicBase::Human : GameLogicBase::AI);
+        }
+        NaiveRenju<N> naive(game);
+        for (int row = 0; row < N; row++) {
+            for (int col = 0; col < N; col++) {
+                if (!game.isMoveValid(row, col))
+                    continue;
+                bool expected = naive.isForbidden(row, col, 1);
+                bool actual = game.isForbidden(row, col, GameLogicBase::Human);
+                if (expected != actual)
+                    fail("renju", "isForbidden за чёрных", expected, actual, row * N + col);
+                if (game.isForbidden(row, col, GameLogicBase::AI))
+                    fail("renju", "isForbidden за белых", 0, 1, row * N + col);
+            }
+        }
+    }
+}
+
+/**
+ * @brief knownRenjuPositions Известные позиции: чёрные камни, ход и ожидаемый запрет.
+ */
+void knownRenjuPositions() {
+    struct Known {
+        const char *name;
+        std::vector<std::pair<int, int>> black, white;
+        std::pair<int, int> move;
+        bool forbidden;
+    };
+    const Known positions[] = {
+        {"3-3", {{7, 5}, {7, 6}, {5, 7}, {6, 7}}, {}, {7, 7}, true},
+        {"3-3 с разрывом", {{7, 4}, {7, 5}, {4, 7}, {6, 7}}, {}, {7, 7}, true},
+        {"3-3 по диагоналям", {{5, 5}, {6, 6}, {5, 9}, {6, 8}}, {}, {7, 7}, true},
+        {"закрытая тройка", {{7, 5}, {7, 6}, {5, 7}, {6, 7}}, {{7, 8}}, {7, 7}, false},
+        {"4-4", {{7, 4}, {7, 5}, {7, 6}, {4, 7}, {5, 7}, {6, 7}}, {}, {7, 7}, true},
+        {"4-4 на одной линии", {{7, 3}, {7, 5}, {7, 6}, {7, 9}}, {}, {7, 7}, true},
+        {"4-3", {{7, 4}, {7, 5}, {7, 6}, {5, 7}, {6, 7}}, {}, {7, 7}, false},
+        {"длинный ряд", {{7, 2}, {7, 3}, {7, 4}, {7, 6}, {7, 7}}, {}, {7, 5}, true},
+        {"пятёрка при 3-3", {{7, 3}, {7, 4}, {7, 5}, {7, 6}, {5, 7}, {6, 7}, {5, 5}, {6, 6}}, {}, {7, 7}, false},
+    };
+    for (const Known &known : positions) {
+        BasicGameLogic<15> game;
+        game.setRules(GameLogicBase::Renju, GameLogicBase::Human);
+        for (auto stone : known.black)
+            game.makeMove(stone.first, stone.second, GameLogicBase::Human);
+        for (auto stone : known.white)
+            game.makeMove(stone.first, stone.second, GameLogicBase::AI);
+        int move = known.move.first * 15 + known.move.second;
+        bool actual = game.isForbidden(known.move.first, known.move.second, GameLogicBase::Human);
+        if (actual != known.forbidden)
+            fail("renju", known.name, known.forbidden, actual, move);
+        if (NaiveRenju<15>(game).isForbidden(known.move.first, known.move.second, 1) != known.forbidden)
+            fail("renju (наивная проверка)", known.name, known.forbidden, !known.forbidden, move);
+    }
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 random(20240601);
+
+    randomGamesEvaluation<15>(random, 200, GameLogicBase::Freestyle);
+    randomGamesEvaluation<15>(random, 50, GameLogicBase::Standard);
+    randomGamesEvaluation<15>(random, 50, GameLogicBase::Renju);
+    randomGamesEvaluation<19>(random, 50, GameLogicBase::Freestyle);
+    randomGamesEvaluation<20>(random, 50, GameLogicBase::Freestyle);
+    knownRenjuPositions();
+    randomRenjuPositions(random, 300);
+
+    if (failures > 0) {
+        std::printf("Не прошло проверок: %d\n", failures);
+        return 1;
+    }
+    std::printf("Все проверки прошли\n");
+    return 0;
+}
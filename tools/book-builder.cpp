@@ -0,0 +1,183 @@
+/*
+ * book-builder.cpp
+ *
+ * Построение дебютной книги (см. opening-book.h) из партий самоигры движка
+ * или из импортированного списка партий.
+ *
+ * Самоигра: первые ходы партии (--random) выбираются случайно среди клеток рядом
+ * с камнями, чтобы партии расходились, дальше обе стороны играет AlphaBetaAI
+ * на глубину --depth. В книгу попадают первые --plies ходов каждой партии:
+ * ходы победителя с весом 2, ходы ничейной партии с весом 1.
+ *
+ * Импорт: файл партий gomoku-qt (.gmk, см. game-record.h) или текстовый файл,
+ * одна партия в строке – ходы "row,col" через пробел (формат GameArchive::exportText);
+ * всё после '#' в строке пропускается.
+ *
+ * Использование: gomoku-book-builder [--selfplay N] [--depth D] [--random K] [--plies P]
+ *                                    [--seed S] [--import FILE] [--min-weight W]
+ *                                    [--output FILE]
+ */
+
+#include "gomoku-engine.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief importGames Добавляет в книгу партии из файла партий или текстового файла.
+ * @return Число добавленных партий или -1, если файл не открылся.
+ */
+int importGames(const std::string &path, int plies, OpeningBookBuilder &builder) {
+    if (GameArchive::isArchive(path)) {
+        if (GameArchive::archiveBoardSize(path) != GameLogic::BOARD_SIZE) {
+            std::fprintf(stderr, "%s: книга строится только для доски %dx%d\n", path.c_str(),
+                         GameLogic::BOARD_SIZE, GameLogic::BOARD_SIZE);
+            return -1;
+        }
+        std::vector<SavedGame> games;
+        std::string error;
+        if (!GameArchive::load(path, games, error)) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return -1;
+        }
+        int added = 0;
+        for (const SavedGame &game : games) {
+            std::vector<std::pair<int, int>> moves;
+            for (const GameLogic::RecordedMove &move : game.moves)
+                moves.emplace_back(move.row, move.col);
+            added += builder.addGame(moves, plies) ? 1 : 0;
+        }
+        return added;
+    }
+
+    std::ifstream file(path);
+    if (!file)
+        return -1;
+    std::string line;
+    int lineNumber = 0, added = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        std::istringstream stream(line);
+        std::vector<std::pair<int, int>> moves;
+        std::string move;
+        bool valid = true;
+        while (valid && stream >> move) {
+            if (move[0] == '#')
+                break;
+            int row, col;
+            char comma;
+            std::istringstream moveStream(move);
+            valid = (moveStream >> row >> comma >> col) && comma == ',';
+            moves.emplace_back(row, col);
+        }
+        if (moves.empty())
+            continue;
+        if (!valid || !builder.addGame(moves, plies)) {
+            std::fprintf(stderr, "%s:%d: неверная партия, пропущена\n", path.c_str(), lineNumber);
+            continue;
+        }
+        added++;
+    }
+    return added;
+}
+
+/**
+ * @brief playGame Играет одну партию движка против самого себя.
+ * @param randomPlies Число первых ходов, выбираемых случайно (первый – всегда в центр).
+ * @param maxMoves Партия без победителя после стольких ходов считается ничьей.
+ */
+std::vector<std::pair<int, int>> playGame(AlphaBetaAI &ai, const SearchLimits &limits, int randomPlies,
+                                          int maxMoves, std::mt19937 &random) {
+    GameLogic game;
+    std::vector<std::pair<int, int>> moves;
+    GameLogic::Player player = GameLogic::Human;
+    while (int(moves.size()) < maxMoves && game.checkWinner() == GameLogic::None && !game.isBoardFull()) {
+        std::pair<int, int> move;
+        if (int(moves.size()) < randomPlies) {
+            // Случайный ход вплотную к камням: так дебют остаётся разумным, но партии различаются.
+            game.setCandidateRadius(1);
+            std::vector<std::pair<int, int>> candidates = game.getCandidateMoves();
+            game.setCandidateRadius(GameLogic::DEFAULT_CANDIDATE_RADIUS);
+            move = candidates[std::uniform_int_distribution<std::size_t>(0, candidates.size() - 1)(random)];
+        } else {
+            move = ai.search(game, limits, player == GameLogic::AI).move;
+        }
+        game.makeMove(move.first, move.second, player);
+        moves.push_back(move);
+        player = (player == GameLogic::Human) ? GameLogic::AI : GameLogic::Human;
+    }
+    return moves;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    int games = 0, depth = 3, randomPlies = 3, plies = 8, minWeight = 1;
+    unsigned seed = 1;
+    std::string importPath;
+    std::string outputPath = "gomoku.book";
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--selfplay") && i + 1 < argc)
+            games = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--depth") && i + 1 < argc)
+            depth = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--random") && i + 1 < argc)
+            randomPlies = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--plies") && i + 1 < argc)
+            plies = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--seed") && i + 1 < argc)
+            seed = unsigned(std::strtoul(argv[++i], nullptr, 10));
+        else if (!std::strcmp(argv[i], "--import") && i + 1 < argc)
+            importPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--min-weight") && i + 1 < argc)
+            minWeight = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--output") && i + 1 < argc)
+            outputPath = argv[++i];
+        else {
+            std::fprintf(stderr,
+                         "Использование: %s [--selfplay N] [--depth D] [--random K] [--plies P] [--seed S] "
+                         "[--import FILE] [--min-weight W] [--output FILE]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (games <= 0 && importPath.empty()) {
+        std::fprintf(stderr, "Нужен источник партий: --selfplay N и/или --import FILE\n");
+        return 1;
+    }
+
+    OpeningBookBuilder builder;
+    if (!importPath.empty()) {
+        int added = importGames(importPath, plies, builder);
+        if (added < 0) {
+            std::fprintf(stderr, "Не удалось открыть %s\n", importPath.c_str());
+            return 1;
+        }
+        std::fprintf(stderr, "Импортировано партий: %d\n", added);
+    }
+
+    AlphaBetaAI ai;
+    SearchLimits limits;
+    limits.maxDepth = depth;
+    limits.useBook = false;
+    std::mt19937 random(seed);
+    for (int i = 0; i < games; i++) {
+        ai.clearHash();
+        std::vector<std::pair<int, int>> moves = playGame(ai, limits, randomPlies, 2 * plies + 60, random);
+        builder.addGame(moves, plies);
+        std::fprintf(stderr, "Партия %d/%d: %zu ходов\n", i + 1, games, moves.size());
+    }
+
+    if (!builder.save(outputPath, minWeight)) {
+        std::fprintf(stderr, "Не удалось записать %s\n", outputPath.c_str());
+        return 1;
+    }
+    std::printf("Книга %s записана, накоплено пар (позиция, ход): %zu\n", outputPath.c_str(), builder.size());
+    return 0;
+}
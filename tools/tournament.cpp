@@ -0,0 +1,370 @@
+/*
+ * tournament.cpp
+ *
+ * Турнир двух конфигураций движка без интерфейса: N партий, распределённых по пулу
+ * рабочих потоков (по умолчанию – по числу ядер), с отчётом о победах, ничьих
+ * и поражениях, разнице Elo с 95% доверительным интервалом и вероятностью
+ * превосходства (LOS). Нужен, чтобы проверять, что ускорение движка не стоило ему силы.
+ *
+ * Партии играются парами: одна и та же дебютная позиция разыгрывается дважды,
+ * и конфигурации меняются цветами. Дебюты для разнообразия:
+ *   - случайные: первый ход в центр, дальше --random ходов вплотную к камням;
+ *   - по дебютной книге (--book): ходы выбираются случайно с вероятностью по весу записи;
+ *   - из файла (--openings): строки "row,col row,col ..." (формат GameArchive::exportText)
+ *     по кругу.
+ *
+ * Конфигурация задаётся строкой ключ=значение через запятую, например
+ * "depth=4,time=0,mode=pvs,threats=20000,radius=2,threads=1,hash=16,book=0":
+ *   depth   – глубина итеративного углубления;   time    – лимит на ход, мс (0 – без лимита);
+ *   mode    – pvs или alphabeta;                  threats – лимит узлов VCF/VCT (0 – не искать);
+ *   radius  – радиус фронтира кандидатов;         threads – потоки поиска Lazy SMP на один ход;
+ *   hash    – размер таблицы транспозиций, МБ;    book    – 1, чтобы брать ходы из --book;
+ *   lmr, futility, nullmove – 0, чтобы выключить приём выборочного поиска (см. SearchLimits);
+ *   quiescence – лимит узлов продления угроз от одного листа (0 – без продления).
+ * Веса оценочной функции – константы PatternEvaluator и в конфигурацию не входят.
+ *
+ * Правила партий (--rules): freestyle (по умолчанию), standard (ровно пять) или renju;
+ * чёрными играет тот, кто ходит первым.
+ *
+ * Использование: gomoku-tournament [--games N] [--workers W] [--a CONFIG] [--b CONFIG]
+ *                                  [--random K] [--book FILE] [--openings FILE]
+ *                                  [--max-moves M] [--seed S] [--save FILE.gmk]
+ *                                  [--rules freestyle|standard|renju]
+ */
+
+#include "gomoku-engine.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Конфигурация движка одного участника.
+struct EngineConfig {
+    SearchLimits limits;
+    int radius = GameLogic::DEFAULT_CANDIDATE_RADIUS;
+    int threads = 1;
+    std::size_t hashMb = 16;
+    std::string text;
+};
+
+// Итог одной партии.
+struct GameOutcome {
+    SavedGame record;
+    int scoreA = 1; // Очки конфигурации A, умноженные на 2: 2 – победа, 1 – ничья, 0 – поражение.
+};
+
+/**
+ * @brief parseConfig Разбирает строку конфигурации "ключ=значение,...".
+ * @return false, если встретился неизвестный ключ или неверное значение.
+ */
+bool parseConfig(const std::string &text, EngineConfig &config, std::string &error) {
+    config.text = text;
+    config.limits.useBook = false;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        std::size_t eq = item.find('=');
+        if (eq == std::string::npos) {
+            error = "ожидается ключ=значение: " + item;
+            return false;
+        }
+        std::string key = item.substr(0, eq);
+        std::string value = item.substr(eq + 1);
+        long number = std::strtol(value.c_str(), nullptr, 10);
+        if (key == "depth" && number > 0)
+            config.limits.maxDepth = int(std::min<long>(number, AlphaBetaAI::MAX_SEARCH_DEPTH));
+        else if (key == "time" && number >= 0)
+            config.limits.timeLimitMs = int(number);
+        else if (key == "mode" && (value == "pvs" || value == "alphabeta"))
+            config.limits.mode = (value == "pvs") ? SearchMode::Pvs : SearchMode::AlphaBeta;
+        else if (key == "threats" && number >= 0)
+            config.limits.threatNodeLimit = number;
+        else if (key == "radius" && number >= 1 && number <= GameLogic::MAX_CANDIDATE_RADIUS)
+            config.radius = int(number);
+        else if (key == "threads" && number >= 1)
+            config.threads = int(number);
+        else if (key == "hash" && number >= 1)
+            config.hashMb = std::size_t(number);
+        else if (key == "book" && (number == 0 || number == 1))
+            config.limits.useBook = number == 1;
+        else if (key == "lmr" && (number == 0 || number == 1))
+            config.limits.lateMoveReductions = number == 1;
+        else if (key == "futility" && (number == 0 || number == 1))
+            config.limits.futilityPruning = number == 1;
+        else if (key == "nullmove" && (number == 0 || number == 1))
+            config.limits.nullMovePruning = number == 1;
+        else if (key == "quiescence" && number >= 0)
+            config.limits.quiescenceNodeLimit = int(number);
+        else {
+            error = "неизвестный параметр конфигурации: " + item;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Правила по имени: freestyle, standard или renju.
+bool parseRules(const char *name, GameLogic::Rules &rules) {
+    if (!std::strcmp(name, "freestyle"))
+        rules = GameLogic::Freestyle;
+    else if (!std::strcmp(name, "standard"))
+        rules = GameLogic::Standard;
+    else if (!std::strcmp(name, "renju"))
+        rules = GameLogic::Renju;
+    else
+        return false;
+    return true;
+}
+
+// Читает дебюты из текстового файла: одна последовательность ходов "row,col" в строке.
+bool loadOpenings(const std::string &path, std::vector<std::vector<std::pair<int, int>>> &openings) {
+    std::ifstream file(path);
+    if (!file)
+        return false;
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream stream(line.substr(0, line.find('#')));
+        std::vector<std::pair<int, int>> moves;
+        std::string move;
+        while (stream >> move) {
+            int row, col;
+            char comma;
+            std::istringstream moveStream(move);
+            if (moveStream >> row >> comma >> col && comma == ',')
+                moves.emplace_back(row, col);
+        }
+        if (!moves.empty())
+            openings.push_back(moves);
+    }
+    return true;
+}
+
+/**
+ * @brief makeOpening Строит дебют пары партий с номером pair.
+ *
+ * Из файла дебюты берутся по кругу; иначе первый ход ставится в центр, а следующие
+ * randomPlies ходов выбираются из книги (случайно по весу записей) или, если книги
+ * нет или позиции в ней нет, случайно среди клеток вплотную к камням.
+ */
+std::vector<std::pair<int, int>> makeOpening(int pair, int randomPlies, const OpeningBook *book,
+                                             const std::vector<std::vector<std::pair<int, int>>> &openings,
+                                             std::mt19937 &random) {
+    if (!openings.empty())
+        return openings[pair % openings.size()];
+
+    GameLogic game;
+    std::vector<std::pair<int, int>> moves;
+    GameLogic::Player player = GameLogic::Human;
+    game.makeMove(GameLogic::BOARD_SIZE / 2, GameLogic::BOARD_SIZE / 2, player);
+    moves.emplace_back(GameLogic::BOARD_SIZE / 2, GameLogic::BOARD_SIZE / 2);
+    for (int ply = 0; ply < randomPlies; ply++) {
+        player = (player == GameLogic::Human) ? GameLogic::AI : GameLogic::Human;
+        std::pair<int, int> move(-1, -1);
+        std::vector<OpeningBook::Entry> entries;
+        if (book)
+            entries = book->entries(game, player);
+        if (!entries.empty()) {
+            std::vector<int> weights;
+            for (const OpeningBook::Entry &entry : entries)
+                weights.push_back(std::max(1, entry.weight));
+            const OpeningBook::Entry &entry =
+                entries[std::discrete_distribution<int>(weights.begin(), weights.end())(random)];
+            if (game.isMoveValid(entry.move / GameLogic::BOARD_SIZE, entry.move % GameLogic::BOARD_SIZE))
+                move = std::make_pair(entry.move / GameLogic::BOARD_SIZE, entry.move % GameLogic::BOARD_SIZE);
+        }
+        if (move.first < 0) {
+            game.setCandidateRadius(1);
+            std::vector<std::pair<int, int>> candidates = game.getCandidateMoves();
+            game.setCandidateRadius(GameLogic::DEFAULT_CANDIDATE_RADIUS);
+            move = candidates[std::uniform_int_distribution<std::size_t>(0, candidates.size() - 1)(random)];
+        }
+        game.makeMove(move.first, move.second, player);
+        moves.push_back(move);
+    }
+    return moves;
+}
+
+/**
+ * @brief playGame Играет одну партию между двумя движками.
+ * @param aFirst Конфигурация A ходит первой (камни Human).
+ */
+GameOutcome playGame(const EngineConfig &configA, const EngineConfig &configB, bool aFirst,
+                     const std::vector<std::pair<int, int>> &opening, int maxMoves,
+                     std::shared_ptr<const OpeningBook> book, GameLogic::Rules rules) {
+    AlphaBetaAI engines[2];
+    const EngineConfig *configs[2] = {&configA, &configB};
+    for (int i = 0; i < 2; i++) {
+        engines[i].setThreadCount(configs[i]->threads);
+        engines[i].setHashSize(configs[i]->hashMb);
+        if (configs[i]->limits.useBook)
+            engines[i].setOpeningBook(book);
+    }
+
+    GameOutcome outcome;
+    GameLogic game;
+    game.setRules(rules, GameLogic::Human);
+    GameLogic::Player player = GameLogic::Human;
+    for (const auto &move : opening) {
+        if (!game.playMove(move.first, move.second, player))
+            break;
+        player = (player == GameLogic::Human) ? GameLogic::AI : GameLogic::Human;
+    }
+    while (game.checkWinner() == GameLogic::None && !game.isBoardFull() && game.moveCount() < maxMoves) {
+        // Human – первый игрок: им играет A, если aFirst.
+        int engine = ((player == GameLogic::Human) == aFirst) ? 0 : 1;
+        game.setCandidateRadius(configs[engine]->radius);
+        SearchResult result = engines[engine].search(game, configs[engine]->limits, player == GameLogic::AI);
+        if (result.move.first < 0)
+            break;
+        game.playMove(result.move.first, result.move.second, player);
+        player = (player == GameLogic::Human) ? GameLogic::AI : GameLogic::Human;
+    }
+
+    int winner = game.checkWinner();
+    outcome.record.moves = game.moveLog();
+    outcome.record.winner = winner;
+    outcome.record.finished = true;
+    if (winner != GameLogic::None)
+        outcome.scoreA = ((winner == GameLogic::Human) == aFirst) ? 2 : 0;
+    return outcome;
+}
+
+// Разница Elo, соответствующая доле очков score (0 < score < 1).
+double eloFromScore(double score) {
+    return -400.0 * std::log10(1.0 / score - 1.0);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    int games = 100, randomPlies = 4, maxMoves = GameLogic::CELL_COUNT;
+    int workers = std::max(1, int(std::thread::hardware_concurrency()));
+    unsigned seed = 1;
+    std::string configTextA = "depth=4", configTextB = "depth=3";
+    std::string bookPath, openingsPath, savePath;
+    GameLogic::Rules rules = GameLogic::Freestyle;
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--games") && i + 1 < argc)
+            games = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--workers") && i + 1 < argc)
+            workers = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--a") && i + 1 < argc)
+            configTextA = argv[++i];
+        else if (!std::strcmp(argv[i], "--b") && i + 1 < argc)
+            configTextB = argv[++i];
+        else if (!std::strcmp(argv[i], "--random") && i + 1 < argc)
+            randomPlies = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--book") && i + 1 < argc)
+            bookPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--openings") && i + 1 < argc)
+            openingsPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--max-moves") && i + 1 < argc)
+            maxMoves = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--seed") && i + 1 < argc)
+            seed = unsigned(std::strtoul(argv[++i], nullptr, 10));
+        else if (!std::strcmp(argv[i], "--save") && i + 1 < argc)
+            savePath = argv[++i];
+        else if (!std::strcmp(argv[i], "--rules") && i + 1 < argc && parseRules(argv[i + 1], rules))
+            i++;
+        else {
+            std::fprintf(stderr,
+                         "Использование: %s [--games N] [--workers W] [--a CONFIG] [--b CONFIG] [--random K] "
+                         "[--book FILE] [--openings FILE] [--max-moves M] [--seed S] [--save FILE.gmk] "
+                         "[--rules freestyle|standard|renju]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    EngineConfig configA, configB;
+    std::string error;
+    if (!parseConfig(configTextA, configA, error) || !parseConfig(configTextB, configB, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    std::shared_ptr<OpeningBook> book;
+    if (!bookPath.empty()) {
+        book = std::make_shared<OpeningBook>();
+        if (!book->open(bookPath)) {
+            std::fprintf(stderr, "Не удалось открыть дебютную книгу %s\n", bookPath.c_str());
+            return 1;
+        }
+    }
+    std::vector<std::vector<std::pair<int, int>>> openings;
+    if (!openingsPath.empty() && (!loadOpenings(openingsPath, openings) || openings.empty())) {
+        std::fprintf(stderr, "Не удалось прочитать дебюты из %s\n", openingsPath.c_str());
+        return 1;
+    }
+
+    // Дебюты строятся заранее и детерминированно по seed, чтобы турнир был воспроизводим
+    // при любом числе рабочих потоков.
+    int pairs = (games + 1) / 2;
+    std::mt19937 random(seed);
+    std::vector<std::vector<std::pair<int, int>>> pairOpenings;
+    for (int pair = 0; pair < pairs; pair++)
+        pairOpenings.push_back(makeOpening(pair, randomPlies, book.get(), openings, random));
+
+    std::vector<GameOutcome> outcomes(games);
+    std::atomic<int> nextGame{0};
+    std::mutex outputMutex;
+    int finished = 0, wins = 0, draws = 0, losses = 0;
+    auto worker = [&]() {
+        for (int index = nextGame++; index < games; index = nextGame++) {
+            bool aFirst = (index % 2) == 0;
+            GameOutcome outcome = playGame(configA, configB, aFirst, pairOpenings[index / 2], maxMoves, book, rules);
+            std::lock_guard<std::mutex> lock(outputMutex);
+            outcomes[index] = outcome;
+            finished++;
+            wins += outcome.scoreA == 2;
+            draws += outcome.scoreA == 1;
+            losses += outcome.scoreA == 0;
+            std::fprintf(stderr, "Партия %d/%d (A %s): %zu ходов, %s; счёт +%d =%d -%d\n", finished, games,
+                         aFirst ? "первым" : "вторым", outcome.record.moves.size(),
+                         outcome.scoreA == 2 ? "победа A" : outcome.scoreA == 1 ? "ничья" : "победа B",
+                         wins, draws, losses);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (int i = 0; i < std::min(workers, games); i++)
+        pool.emplace_back(worker);
+    for (std::thread &thread : pool)
+        thread.join();
+
+    // Доля очков A, её стандартная ошибка по разбросу результатов партий и интервал в Elo.
+    int total = wins + draws + losses;
+    double score = total > 0 ? (wins + 0.5 * draws) / total : 0.5;
+    double variance = total > 0 ? (wins * (1.0 - score) * (1.0 - score) + draws * (0.5 - score) * (0.5 - score) +
+                                   losses * score * score) / total : 0.0;
+    double margin = total > 0 ? 1.96 * std::sqrt(variance / total) : 0.0;
+    auto clampScore = [](double s) { return std::min(0.999, std::max(0.001, s)); };
+    double los = (wins + losses) > 0 ? 0.5 * (1.0 + std::erf((wins - losses) / std::sqrt(2.0 * (wins + losses))))
+                                     : 0.5;
+
+    std::printf("A: %s\nB: %s\n", configA.text.c_str(), configB.text.c_str());
+    std::printf("Партий: %d, потоков: %d\n", total, std::min(workers, games));
+    std::printf("A: +%d =%d -%d, очки %.1f%%\n", wins, draws, losses, score * 100.0);
+    std::printf("Elo A - B: %+.1f (95%%: %+.1f .. %+.1f), LOS %.1f%%\n", eloFromScore(clampScore(score)),
+                eloFromScore(clampScore(score - margin)), eloFromScore(clampScore(score + margin)), los * 100.0);
+
+    if (!savePath.empty()) {
+        std::vector<SavedGame> records;
+        for (const GameOutcome &outcome : outcomes)
+            records.push_back(outcome.record);
+        if (!GameArchive::save(savePath, records)) {
+            std::fprintf(stderr, "Не удалось записать %s\n", savePath.c_str());
+            return 1;
+        }
+    }
+    return 0;
+}